@@ -11,11 +11,11 @@ namespace Adsp {
 
 #ifdef USE_STRICT_CONSTEXPR
 double panLeftAmplitude(double panning) {
-	return cos(panning * 0.25 * M_PI + (0.25 * M_PI)) * PAN_BOOST;
+	return fastCosPi(panning * 0.25 + 0.25) * PAN_BOOST;
 }
 
 double panRightAmplitude(double panning) {
-	return sin(panning * 0.25 * M_PI + (0.25 * M_PI)) * PAN_BOOST;
+	return fastSinPi(panning * 0.25 + 0.25) * PAN_BOOST;
 }
 
 double panLeft(double value, double panning) {
@@ -10,6 +10,8 @@
 
 #include <cmath>
 
+#include "FastMath.h"
+
 namespace Adsp {
 /**
  * @defgroup basic
@@ -88,7 +90,7 @@ double mix3(double value1, double value2, double value3, int mixMode);
  * @return The amplitude of the left channel. This can be between 0 and PAN_BOOST, and will be 1 when the panning is centered.
  */
 constexpr double panLeftAmplitude(double panning) {
-	return cos(panning * 0.25 * M_PI + (0.25 * M_PI)) * PAN_BOOST;
+	return fastCosPi(panning * 0.25 + 0.25) * PAN_BOOST;
 }
 
 /**
@@ -99,7 +101,7 @@ constexpr double panLeftAmplitude(double panning) {
  * @return The amplitude of the right channel. This can be between 0 and PAN_BOOST, and will be 1 when the panning is centered.
  */
 constexpr double panRightAmplitude(double panning) {
-	return sin(panning * 0.25 * M_PI + (0.25 * M_PI)) * PAN_BOOST;
+	return fastSinPi(panning * 0.25 + 0.25) * PAN_BOOST;
 }
 
 /**
@@ -7,23 +7,27 @@
 
 #include "CachedFir.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "Technical/Log.h"
+#include "Vector.h"
 
 namespace Adsp {
 
-FirCoefficientCache::FirCoefficientCache() {
-	for(int i = 0; i < TOTAL_SIZE; i += FILTER_KERNEL_SIZE) {
-		m_storage[i] = -10.0;
-	}
+FirCoefficientCache::FirCoefficientCache(int filterType, double sampleRate) :
+		m_filterType(filterType),
+		m_sampleRate(sampleRate) {
+	m_slabs.fill(nullptr);
 }
 
 FirCoefficientCache::~FirCoefficientCache() {
 }
 
 int FirCoefficientCache::freqToIndex(double frequency) {
-	return int((std::log2(frequency) - 4) * 100.0 + 0.5); //+0.5 is for rounding.
+	double index = (std::log2(frequency) - 4) * 100.0 + 0.5; //+0.5 is for rounding.
+	//Clamped as a double, so that frequencies of 0 (which give -infinity) are handled too.
+	return int(std::max(0.0, std::min(index, NUM_FILTERS - 1.0)));
 }
 
 double FirCoefficientCache::indexToFreq(int index) {
@@ -34,28 +38,26 @@ double FirCoefficientCache::roundFrequency(double frequency) {
 	return indexToFreq(freqToIndex(frequency));
 }
 
-bool FirCoefficientCache::hasCoefficientsFor(double frequency) {
-	return m_storage[freqToIndex(frequency) * FILTER_KERNEL_SIZE] != -10.0;
-}
-
-double* FirCoefficientCache::getCoefficientsFor(double frequency) {
-	return &m_storage[freqToIndex(frequency) * FILTER_KERNEL_SIZE];
-}
-
-void FirCoefficientCache::writeCoefficientsFor(double frequency, double* coefficients) {
-	double* writeTo = &m_storage[freqToIndex(frequency) * FILTER_KERNEL_SIZE];
-	for(int i = 0; i < FILTER_KERNEL_SIZE; i++) {
-		*writeTo = *coefficients;
-		writeTo++;
-		coefficients++;
-	}
-}
-
 FirFilterCache* FirFilterCache::s_instance = nullptr;
 
-FirFilterCache::FirFilterCache() {
-	createHammingWindow(FILTER_KERNEL_SIZE, &m_windows[0]);
-	createBlackmanWindow(FILTER_KERNEL_SIZE, &m_windows[FILTER_KERNEL_SIZE]);
+FirFilterCache::FirFilterCache() :
+		m_cacheCount(0),
+		m_requestsWritten(0),
+		m_requestsRead(0),
+		m_computedWritten(0),
+		m_computedRead(0) {
+	for(std::atomic<FirCoefficientCache*>& cache : m_caches) {
+		cache.store(nullptr, std::memory_order_relaxed);
+	}
+	//Not value-initialized, so the OS only commits the pages of slabs that are actually used.
+	for(int i = 0; i < MAX_SLABS; i++) {
+		m_slabs.push_back(new FirCoefficientSlab);
+		m_slabs.back()->m_taps.fill(0);
+	}
+	//Two taps in the middle give the same half sample of delay as every other kernel.
+	m_passThrough.fill(0.0);
+	m_passThrough[FILTER_KERNEL_SIZE / 2 - 1] = 0.5;
+	m_passThrough[FILTER_KERNEL_SIZE / 2] = 0.5;
 }
 
 FirFilterCache* FirFilterCache::getInstance() {
@@ -66,70 +68,348 @@ FirFilterCache* FirFilterCache::getInstance() {
 }
 
 FirFilterCache::~FirFilterCache() {
+	for(int i = 0; i < m_cacheCount.load(); i++) {
+		delete m_caches[i].load();
+	}
+	for(FirCoefficientSlab* slab : m_slabs) {
+		delete slab;
+	}
+}
 
+FirCoefficientCache* FirFilterCache::findCache(int filterType, double sampleRate) {
+	int count = m_cacheCount.load(std::memory_order_acquire);
+	for(int i = 0; i < count; i++) {
+		FirCoefficientCache* cache = m_caches[i].load(std::memory_order_relaxed);
+		if(cache->getFilterType() == filterType && cache->getSampleRate() == sampleRate) {
+			return cache;
+		}
+	}
+	return nullptr;
 }
 
-double* FirFilterCache::getCoefficientsFor(int filterType, double frequency, double sampleRate) {
-	if(m_caches.count(filterType) == 0) {
-		m_caches[filterType] = new FirCoefficientCache();
+FirCoefficientCache* FirFilterCache::prepareCache(int filterType, double sampleRate) {
+	FirCoefficientCache* cache = findCache(filterType, sampleRate);
+	int count = m_cacheCount.load(std::memory_order_relaxed);
+	if(cache == nullptr && count < MAX_CACHES) {
+		cache = new FirCoefficientCache(filterType, sampleRate);
+		m_caches[count].store(cache, std::memory_order_relaxed);
+		//Storing the count with release makes sure the audio thread sees the cache before it sees the count.
+		m_cacheCount.store(count + 1, std::memory_order_release);
 		info("Created a new FIR coefficient cache");
 	}
-	FirCoefficientCache* cache = m_caches[filterType];
-	double* coArray = cache->getCoefficientsFor(frequency);
-	if(!cache->hasCoefficientsFor(frequency)) {
-		frequency = FirCoefficientCache::roundFrequency(frequency);
-		double* window = &m_windows[(filterType >> 3) * FILTER_KERNEL_SIZE]; //The first three bits tell the filter type, the next bit (or more in the future) say the window type.
-		int type = filterType & 0b111;
-		double freqFrac = frequency / sampleRate;
-		switch(type) {
-		case FilterType::LOWPASS:
-			createLowpassCoefficients(FILTER_KERNEL_SIZE, coArray, freqFrac, window);
-			break;
-		case FilterType::HIGHPASS:
-			createHighpassCoefficients(FILTER_KERNEL_SIZE, coArray, freqFrac, window);
-			break;
+	return cache;
+}
+
+std::vector<FirCoefficientCache*> FirFilterCache::getCaches() {
+	std::vector<FirCoefficientCache*> caches;
+	int count = m_cacheCount.load(std::memory_order_acquire);
+	for(int i = 0; i < count; i++) {
+		caches.push_back(m_caches[i].load(std::memory_order_relaxed));
+	}
+	return caches;
+}
+
+void FirFilterCache::releaseOtherSampleRates(double sampleRate) {
+	int count = m_cacheCount.load(), kept = 0;
+	for(int i = 0; i < count; i++) {
+		FirCoefficientCache* cache = m_caches[i].load();
+		if(cache->getSampleRate() == sampleRate || cache->hasTable()) {
+			m_caches[kept++].store(cache);
+		} else {
+			for(FirCoefficientSlab*& slab : cache->m_slabs) {
+				if(slab != nullptr) {
+					slab->m_owner = nullptr;
+					slab->m_lastUsed = 0; //So takeSlab() uses it before evicting anything.
+					slab->m_generation++;
+				}
+			}
+			delete cache;
 		}
 	}
-	return coArray;
+	for(int i = kept; i < count; i++) {
+		m_caches[i].store(nullptr);
+	}
+	m_cacheCount.store(kept);
+
+	//The queues may point to caches that were just deleted.
+	m_requestsRead.store(m_requestsWritten.load());
+	m_computedRead.store(m_computedWritten.load());
+	for(int i = 0; i < kept; i++) {
+		m_caches[i].load()->m_requested.reset();
+		m_caches[i].load()->m_computed.reset(); //Some of them may have been in the queue.
+	}
+}
+
+FirCoefficientSlab* FirFilterCache::takeSlab() {
+	//Slabs no cache has were never used, or were last used longest ago, so they are taken first.
+	FirCoefficientSlab* slab = m_slabs[0];
+	for(FirCoefficientSlab* other : m_slabs) {
+		if(other->m_lastUsed < slab->m_lastUsed) {
+			slab = other;
+		}
+	}
+	if(slab->m_owner != nullptr) {
+		*slab->m_owner = nullptr; //Take it away from the cache that has it.
+	}
+	slab->m_generation++;
+	slab->m_taps.fill(0);
+	return slab;
+}
+
+void FirFilterCache::collectComputed() {
+	unsigned int read = m_computedRead.load(std::memory_order_relaxed);
+	unsigned int written = m_computedWritten.load(std::memory_order_acquire);
+	for(; read != written; read++) {
+		ComputedKernel& computed = m_computed[read % COMPUTED_QUEUE];
+		FirCoefficientCache* cache = computed.m_cache;
+		cache->m_requested.reset(computed.m_index);
+		FirCoefficientSlab*& slot = cache->getSlabFor(computed.m_index);
+		if(slot == nullptr) {
+			slot = takeSlab();
+			slot->m_owner = &slot;
+			m_uses++;
+			slot->m_lastUsed = m_uses;
+		}
+		std::copy(computed.m_kernel.begin(), computed.m_kernel.end(), slot->getCoefficients(computed.m_index));
+		slot->getTaps(computed.m_index) = computed.m_taps;
+	}
+	//Storing with release makes sure computeRequested() only reuses the entries once they have been copied.
+	m_computedRead.store(read, std::memory_order_release);
+}
+
+void FirFilterCache::request(FirCoefficientCache* cache, int index) {
+	if(cache->m_requested.test(index)) {
+		return;
+	}
+	unsigned int written = m_requestsWritten.load(std::memory_order_relaxed);
+	if(written - m_requestsRead.load(std::memory_order_acquire) < unsigned(REQUEST_QUEUE)) {
+		m_requests[written % REQUEST_QUEUE] = { cache, index };
+		m_requestsWritten.store(written + 1, std::memory_order_release);
+		cache->m_requested.set(index);
+	}
+}
+
+bool FirFilterCache::compute(FirCoefficientCache* cache, int index) {
+	unsigned int written = m_computedWritten.load(std::memory_order_relaxed);
+	if(written - m_computedRead.load(std::memory_order_acquire) == unsigned(COMPUTED_QUEUE)) {
+		return false;
+	}
+	ComputedKernel& computed = m_computed[written % COMPUTED_QUEUE];
+	computed.m_cache = cache;
+	computed.m_index = index;
+	computed.m_taps = computeCoefficients(cache->getFilterType(), index, cache->getSampleRate(), computed.m_kernel.data());
+	m_computedWritten.store(written + 1, std::memory_order_release);
+	cache->m_computed.set(index);
+	return true;
+}
+
+bool FirFilterCache::computeRequested() {
+	unsigned int read = m_requestsRead.load(std::memory_order_relaxed);
+	if(read == m_requestsWritten.load(std::memory_order_acquire)) {
+		return false;
+	}
+	//Computed even if it was computed before, since it must have been evicted since then.
+	KernelRequest request = m_requests[read % REQUEST_QUEUE];
+	if(!compute(request.m_cache, request.m_index)) {
+		return false;
+	}
+	m_requestsRead.store(read + 1, std::memory_order_release);
+	return true;
+}
+
+bool FirFilterCache::prewarm(FirCoefficientCache* cache, int index) {
+	if(cache->hasTable() || cache->m_computed.test(index)) {
+		return true;
+	}
+	return compute(cache, index);
+}
+
+int FirFilterCache::chooseTaps(int filterType, double freqFrac) {
+	if(filterType & FilterType::FULL_QUALITY) {
+		return FILTER_KERNEL_SIZE;
+	}
+	//How wide the transition band of each window is, in fractions of the sample rate, times the number of taps.
+	double windowWidth = (filterType & FilterType::BLACKMAN) ? 5.5 : 3.3;
+	double transition = freqFrac * ((filterType & FilterType::HIGH_QUALITY) ? 0.125 : 0.25);
+	transition = std::min(transition, (0.5 - freqFrac) * 2.0); //Keep the transition band below nyquist.
+	double taps = windowWidth / transition;
+	if(!(taps < FILTER_KERNEL_SIZE)) { //Also catches cutoffs of 0 and above nyquist.
+		return FILTER_KERNEL_SIZE;
+	}
+	//taps is below FILTER_KERNEL_SIZE, which is a multiple of TAPS_STEP, so rounding up can't go past it.
+	int rounded = (int(taps) + TAPS_STEP - 1) / TAPS_STEP * TAPS_STEP;
+	return (rounded < MIN_TAPS) ? MIN_TAPS : rounded;
+}
+
+int FirFilterCache::computeCoefficients(int filterType, int index, double sampleRate, double* kernel) {
+	double frequency = FirCoefficientCache::indexToFreq(index);
+	int type = filterType & 0b111; //The first three bits tell the filter type, the rest say the window type and quality.
+	double freqFrac = frequency / sampleRate;
+	int taps = chooseTaps(filterType, freqFrac);
+	std::array<double, FILTER_KERNEL_SIZE> window;
+	if(filterType & FilterType::BLACKMAN) {
+		createBlackmanWindow(taps, window.data());
+	} else {
+		createHammingWindow(taps, window.data());
+	}
+	//Shorter kernels go in the middle, so the filter delays the signal by the same amount no matter how many taps it uses.
+	std::fill(kernel, kernel + FILTER_KERNEL_SIZE, 0.0);
+	double* start = kernel + (FILTER_KERNEL_SIZE - taps) / 2;
+	switch(type) {
+	case FilterType::LOWPASS:
+		createLowpassCoefficients(taps, start, freqFrac, window.data());
+		break;
+	case FilterType::HIGHPASS:
+		createHighpassCoefficients(taps, start, freqFrac, window.data());
+		break;
+	}
+	return taps;
+}
+
+const double* FirFilterCache::getCoefficientsFor(int filterType, double frequency, double sampleRate, int& taps, const FirCoefficientSlab*& slab) {
+	FirCoefficientCache* cache = findCache(filterType, sampleRate);
+	if(cache == nullptr) {
+		return nullptr;
+	}
+	collectComputed();
+	int index = FirCoefficientCache::freqToIndex(frequency);
+	slab = nullptr;
+	if(cache->hasTable()) {
+		taps = cache->getTableTaps(index);
+		return cache->getTableCoefficients(index) + (FILTER_KERNEL_SIZE - taps) / 2;
+	}
+	int found = index;
+	FirCoefficientSlab* slot = cache->getSlabFor(index);
+	if(slot == nullptr || slot->getTaps(index) == 0) {
+		request(cache, index);
+		//Use the closest cutoff that has been computed until this one has.
+		found = -1;
+		for(int s = 0; s < FirCoefficientCache::NUM_SLABS; s++) {
+			FirCoefficientSlab* other = cache->m_slabs[s];
+			if(other == nullptr) {
+				continue;
+			}
+			int last = std::min((s + 1) * FirCoefficientCache::SLAB_FILTERS, int(FirCoefficientCache::NUM_FILTERS));
+			for(int i = s * FirCoefficientCache::SLAB_FILTERS; i < last; i++) {
+				if(other->getTaps(i) != 0 && (found == -1 || std::abs(i - index) < std::abs(found - index))) {
+					found = i;
+					slot = other;
+				}
+			}
+		}
+		if(found == -1) {
+			return nullptr;
+		}
+	}
+	m_uses++;
+	slot->m_lastUsed = m_uses;
+	slab = slot;
+	taps = slot->getTaps(found);
+	return slot->getCoefficients(found) + (FILTER_KERNEL_SIZE - taps) / 2;
+}
+
+void FirFilterCache::attachTable(int filterType, double sampleRate, const double* coefficients, const int* taps) {
+	FirCoefficientCache* cache = prepareCache(filterType, sampleRate);
+	if(cache != nullptr) {
+		cache->setTable(coefficients, taps);
+	}
 }
 
 void CachedFirFilter::compute(AtomSynth::AudioBuffer& input, AtomSynth::AudioBuffer& output) {
-	double value;
-	int ins, offset = input.getSize() - output.getSize();
+	//The newest sample used for output sample s is input sample offset + s.
+	int offset = input.getSize() - output.getSize();
 	constexpr int N = FirFilterCache::FILTER_KERNEL_SIZE;
-	assert(offset >= N);
+	assert(offset >= N - 1);
 	for(int c = 0; c < input.getChannels(); c++) {
-		std::vector<double>::iterator inputIter = input.getData().begin() + c * input.getSize(),
-				outputIter = output.getData().begin() + c * output.getSize();
-		inputIter += offset - N - 1;
-		for(int s = 0; s < output.getSize(); s++) {
-			value = 0.0;
-			ins = s + offset - N - 1;
-			for(int i = 0; i < N; i++) {
-				value += *(inputIter + i) * *(m_coPointer + i);
+		const double * inputData = input.getReadData() + c * input.getSize() + offset - (N - 1);
+		firBlock(inputData + m_offset, m_coPointer, m_taps, output.getData() + c * output.getSize(), output.getSize());
+	}
+}
+
+double CachedFirFilter::compute(AtomSynth::AudioBuffer& input, int channel, int startSample) {
+	return dotProductBlock(input.getReadData() + channel * input.getSize() + startSample + m_offset, m_coPointer, m_taps);
+}
+
+void CachedFirFilter::rememberChannel(int channel) {
+	if(channel >= int(m_channels.size())) {
+		m_channels.resize(channel + 1);
+	}
+	ChannelState& state = m_channels[channel];
+	state.m_coPointer = m_coPointer;
+	state.m_taps = m_taps;
+	state.m_offset = m_offset;
+	state.m_slab = m_slab;
+	state.m_generation = m_generation;
+}
+
+void CachedFirFilter::computeBlock(AtomSynth::AudioBuffer& input, AtomSynth::AudioBuffer& output, int channels) {
+	int samples = output.getSize();
+	for(int c = 0; c < channels; c++) {
+		rememberChannel(c);
+	}
+	if(m_taps <= MAX_DIRECT_TAPS) {
+		//Short kernels are faster to compute directly than with FFTs.
+		for(int c = 0; c < channels; c++) {
+			firBlock(input.getReadData() + c * input.getSize() + m_offset, m_coPointer, m_taps, output.getData() + c * samples, samples);
+		}
+		return;
+	}
+	if(m_convolverCoPointer != m_coPointer || m_convolverGeneration != m_generation) {
+		//compute() lines the coefficients up with the oldest sample first, a convolution kernel starts with the newest.
+		//The convolver always gets the whole kernel, including the 0s either side of the taps that are used.
+		std::array<double, SIZE> kernel;
+		const double* whole = m_coPointer - m_offset;
+		std::reverse_copy(whole, whole + SIZE, kernel.begin());
+		m_convolver.setKernel(kernel.data());
+		m_convolverCoPointer = m_coPointer;
+		m_convolverGeneration = m_generation;
+	}
+	for(int c = 0; c < channels; c += 2) {
+		//The newest sample compute() uses for output sample s is input sample s + SIZE - 1.
+		double * first = input.getReadData() + c * input.getSize() + SIZE - 1,
+				* firstOutput = output.getData() + c * samples;
+		if(c + 1 < channels) {
+			m_convolver.process(first, first + input.getSize(), firstOutput, firstOutput + samples, samples);
+		} else {
+			m_convolver.process(first, nullptr, firstOutput, nullptr, samples);
+		}
+	}
+}
+
+void CachedFirFilter::computeCrossfaded(int channel, const double* history, double* output, int samples) {
+	firBlock(history + m_offset, m_coPointer, m_taps, output, samples);
+	if(channel < int(m_channels.size())) {
+		ChannelState& previous = m_channels[channel];
+		//Once its slab has been given to another cache, the old pointer does not point to the old coefficients any more, so it is not crossfaded.
+		if(previous.m_coPointer != nullptr && previous.m_coPointer != m_coPointer
+				&& stillValid(previous.m_slab, previous.m_generation)) {
+			//The filter is linear, so fading between the outputs is the same as fading between the coefficients.
+			if(int(m_crossfadeBuffer.size()) < samples) {
+				m_crossfadeBuffer.resize(samples);
+			}
+			double* old = m_crossfadeBuffer.data();
+			firBlock(history + previous.m_offset, previous.m_coPointer, previous.m_taps, old, samples);
+			double step = 1.0 / samples;
+			for(int s = 0; s < samples; s++) {
+				output[s] = old[s] + (output[s] - old[s]) * ((s + 1) * step);
 			}
-			*outputIter = value;
-			inputIter++;
-			outputIter++;
 		}
 	}
+	rememberChannel(channel);
 }
 
-double CachedFirFilter::compute(AtomSynth::AudioBuffer& input, int channel, int startSample) {
-	double tr = 0.0;
-	std::vector<double>::iterator inputIter = input.getData().begin() + channel * input.getSize() + startSample;
-	constexpr int N = FirFilterCache::FILTER_KERNEL_SIZE;
-	for(int i = 0; i < N; i++) {
-		tr += *inputIter * *(m_coPointer + i);
-		inputIter++;
+void CachedFirFilter::linkChannels(int channels) {
+	if(m_channels.empty()) {
+		return;
 	}
-	return tr;
+	m_channels.resize(std::max(channels, int(m_channels.size())), m_channels[0]);
+	std::fill(m_channels.begin() + 1, m_channels.begin() + channels, m_channels[0]);
 }
 
 void CachedFirFilter::drawToConsole() {
 	constexpr int HEIGHT = 64;
 	double min = 0.0, max = 0.0;
-	constexpr int N = FirFilterCache::FILTER_KERNEL_SIZE;
+	int N = m_taps;
 	for(int i = 0; i < N; i++) {
 		double c = *(m_coPointer + i);
 		if(c < min) {
@@ -173,7 +453,23 @@ void CachedFirFilter::drawToConsole() {
 }
 
 void CachedFirFilter::set(int filterType, double frequency, double sampleRate) {
-	m_coPointer = FirFilterCache::getInstance()->getCoefficientsFor(filterType, frequency, sampleRate);
+	FirFilterCache* cache = FirFilterCache::getInstance();
+	const FirCoefficientSlab* slab = nullptr;
+	int taps;
+	const double* coefficients = cache->getCoefficientsFor(filterType, frequency, sampleRate, taps, slab);
+	if(coefficients == nullptr) {
+		//Nothing for this filter type has been computed yet.
+		if(m_coPointer != nullptr && stillValid(m_slab, m_generation)) {
+			return;
+		}
+		coefficients = cache->getPassThrough(taps);
+		slab = nullptr;
+	}
+	m_coPointer = coefficients;
+	m_taps = taps;
+	m_offset = (SIZE - m_taps) / 2;
+	m_slab = slab;
+	m_generation = (slab == nullptr) ? 0 : slab->m_generation;
 }
 
 } /* namespace Adsp */
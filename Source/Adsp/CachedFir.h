@@ -9,8 +9,11 @@
 #define SOURCE_ADSP_CACHEDFIR_H_
 
 #include <array>
-#include <map>
+#include <atomic>
+#include <bitset>
+#include <vector>
 
+#include "Convolution.h"
 #include "Fir.h"
 
 namespace Adsp {
@@ -19,44 +22,322 @@ namespace FilterType {
 	static constexpr int LOWPASS = 0b0000,
 			HIGHPASS = 0b0001,
 			HAMMING = 0b0000,
-			BLACKMAN = 0b1000;
+			BLACKMAN = 0b1000,
+			NORMAL_QUALITY = 0b000000, ///< The transition band is a quarter of the cutoff frequency wide.
+			HIGH_QUALITY = 0b010000, ///< The transition band is an eighth of the cutoff frequency wide.
+			FULL_QUALITY = 0b100000; ///< Always use every coefficient, like the filters did before kernel sizes were adaptive.
 }
 
+class FirCoefficientSlab;
+
+/**
+ * The coefficients for every cutoff of one filter type at
+ * one sample rate. Cutoffs are a hundredth of an octave
+ * apart. The coefficients are stored in slabs of
+ * SLAB_FILTERS kernels, which are only given to the cache
+ * once one of their cutoffs has been computed, and can be
+ * taken away again by FirFilterCache when too much memory
+ * is in use. If a
+ * complete table of them has been loaded from disk (see
+ * FirFilterCache::attachTable()), that is used instead and
+ * no slabs are needed at all.
+ */
 class FirCoefficientCache {
 public:
 	static constexpr int FILTER_KERNEL_SIZE = 512,
 			NUM_FILTERS = 1029, //The x-coordinate at which 2^{\frac{x}{100}+4} reaches 20k.
-			TOTAL_SIZE = FILTER_KERNEL_SIZE * NUM_FILTERS;
+			SLAB_FILTERS = 16, ///< How many kernels are in each slab.
+			NUM_SLABS = (NUM_FILTERS + SLAB_FILTERS - 1) / SLAB_FILTERS;
 private:
-	std::array<double, TOTAL_SIZE> m_storage;
-	static int freqToIndex(double frequency);
-	static double indexToFreq(int index);
+	int m_filterType;
+	double m_sampleRate;
+	std::array<FirCoefficientSlab*, NUM_SLABS> m_slabs; ///< nullptr for slabs that have not been used, or were evicted.
+	const double* m_table = nullptr; ///< NUM_FILTERS kernels one after the other, or nullptr if there is no table.
+	const int* m_tableTaps = nullptr; ///< How many coefficients are not 0 in each kernel of m_table.
+	std::bitset<NUM_FILTERS> m_requested; ///< Kernels the audio thread is waiting for FirFilterCache::computeRequested() to compute.
+	std::bitset<NUM_FILTERS> m_computed; ///< Kernels that have been computed for the audio thread. Only used by the thread that computes them.
 public:
-	FirCoefficientCache();
+	FirCoefficientCache(int filterType, double sampleRate);
 	~FirCoefficientCache();
 
+	/**
+	 * Gets the index of the cached cutoff closest to a
+	 * frequency, clamped to the range that is cached.
+	 */
+	static int freqToIndex(double frequency);
+	static double indexToFreq(int index);
 	static double roundFrequency(double frequency);
 
-	bool hasCoefficientsFor(double frequency);
-	double* getCoefficientsFor(double frequency);
-	void writeCoefficientsFor(double frequency, double* coefficients);
+	int getFilterType() {
+		return m_filterType;
+	}
+	double getSampleRate() {
+		return m_sampleRate;
+	}
+	/**
+	 * Gets the slot for the slab holding a cutoff, so that
+	 * FirFilterCache can put a slab in it.
+	 * @param index The index of the cutoff, from freqToIndex().
+	 * @return The slab, or nullptr if it has not been allocated.
+	 */
+	FirCoefficientSlab*& getSlabFor(int index) {
+		return m_slabs[index / SLAB_FILTERS];
+	}
+	/**
+	 * Makes this cache use a complete, read only table of
+	 * coefficients instead of computing them. The memory is
+	 * not copied, so it has to stay valid for as long as
+	 * this cache exists.
+	 * @param coefficients NUM_FILTERS kernels of FILTER_KERNEL_SIZE coefficients, one after the other.
+	 * @param taps How many coefficients in the middle of each kernel are not 0.
+	 */
+	void setTable(const double* coefficients, const int* taps) {
+		m_table = coefficients;
+		m_tableTaps = taps;
+	}
+	bool hasTable() {
+		return m_table != nullptr;
+	}
+	const double* getTableCoefficients(int index) {
+		return m_table + index * FILTER_KERNEL_SIZE;
+	}
+	int getTableTaps(int index) {
+		return m_tableTaps[index];
+	}
+
+	friend class FirFilterCache;
+};
+
+/**
+ * SLAB_FILTERS kernels of coefficients, which belong to
+ * whichever FirCoefficientCache is using them at the moment.
+ * Slabs are never deleted while the synth is running, so a
+ * pointer into one can always be read, but once
+ * m_generation changes it may point to the coefficients of
+ * a different filter.
+ */
+class FirCoefficientSlab {
+public:
+	static constexpr int FILTERS = FirCoefficientCache::SLAB_FILTERS,
+			KERNEL_SIZE = FirCoefficientCache::FILTER_KERNEL_SIZE;
+	std::array<double, KERNEL_SIZE * FILTERS> m_storage;
+	std::array<int, FILTERS> m_taps; ///< How many coefficients in the middle of each kernel are not 0, or 0 if the kernel has not been computed yet.
+	unsigned long long m_lastUsed = 0; ///< When this slab was last used, see FirFilterCache::m_uses.
+	FirCoefficientSlab** m_owner = nullptr; ///< The slot in a FirCoefficientCache that points to this slab, or nullptr if no cache has it.
+	unsigned int m_generation = 0; ///< Changes every time the slab is taken from one cache and given to another.
+
+	double* getCoefficients(int index) {
+		return &m_storage[(index % FILTERS) * KERNEL_SIZE];
+	}
+	int& getTaps(int index) {
+		return m_taps[index % FILTERS];
+	}
 };
 
+/**
+ * Creates and stores coefficients for every CachedFirFilter.
+ * There is one FirCoefficientCache for each filter type and
+ * sample rate that has been prepared with prepareCache().
+ * The slabs they use all come from here. All MAX_SLABS of
+ * them are allocated up front, and once every one is in
+ * use, the least recently used one is taken away from its
+ * cache and reused, so the audio thread never allocates
+ * anything.
+ *
+ * The audio thread never computes coefficients either.
+ * When a cutoff it asks for is missing, it gets the closest
+ * one that has been computed, and the missing one is
+ * queued for another thread to compute with
+ * computeRequested(). The finished kernel is queued back,
+ * and the audio thread copies it into a slab the next time
+ * it looks anything up. Cutoffs that are known to be
+ * needed can be computed ahead of time with prewarm(),
+ * which hands them over the same way, so they take up
+ * slabs like any other kernel, and the coefficients never
+ * use more than the MAX_SLABS, apart from the
+ * COMPUTED_QUEUE kernels waiting to be collected.
+ */
 class FirFilterCache {
 public:
-	static constexpr int FILTER_COMBINATIONS = 16, //8 possible filter types, 2 possible window types.
+	static constexpr int FILTER_COMBINATIONS = 48, //8 possible filter types, 2 possible window types, 3 qualities.
 			WINDOW_TYPES = 2,
-			FILTER_KERNEL_SIZE = FirCoefficientCache::FILTER_KERNEL_SIZE;
+			FILTER_KERNEL_SIZE = FirCoefficientCache::FILTER_KERNEL_SIZE,
+			MIN_TAPS = 32, ///< The shortest kernel that will be used, no matter how high the cutoff is.
+			TAPS_STEP = 32, ///< Kernel sizes are rounded up to a multiple of this.
+			MAX_SLABS = 128, ///< Each slab is 64kB, so this caps the coefficients at 8MB.
+			MAX_CACHES = 4 * FILTER_COMBINATIONS, ///< How many caches prepareCache() can make, enough for every filter type at a few sample rates.
+			REQUEST_QUEUE = 64, ///< How many missing kernels can be waiting to be computed at once.
+			COMPUTED_QUEUE = 64, ///< How many computed kernels can be waiting for the audio thread at once. Each one is 4kB.
+			COEFFICIENT_VERSION = 2; ///< Change this whenever computeCoefficients() changes what it computes, so tables saved before then are not used.
 private:
-	std::array<double, FILTER_KERNEL_SIZE * WINDOW_TYPES> m_windows;
-	std::map<int, FirCoefficientCache*> m_caches;
+	std::array<std::atomic<FirCoefficientCache*>, MAX_CACHES> m_caches; ///< Only added to by prepareCache(). There are only ever a few of these, so searching them one by one is faster than a map.
+	std::atomic<int> m_cacheCount;
+	std::vector<FirCoefficientSlab*> m_slabs; ///< Every slab, allocated by the constructor.
+	unsigned long long m_uses = 0; ///< Counts every time coefficients are requested, to find the least recently used slab.
+	std::array<double, FILTER_KERNEL_SIZE> m_passThrough; ///< See getPassThrough().
+	struct KernelRequest {
+		FirCoefficientCache* m_cache;
+		int m_index;
+	};
+	struct ComputedKernel {
+		FirCoefficientCache* m_cache;
+		int m_index, m_taps;
+		std::array<double, FILTER_KERNEL_SIZE> m_kernel;
+	};
+	//Both queues only have one thread writing and one reading. The counters only ever go up, entry n is at n % the size of the queue.
+	std::array<KernelRequest, REQUEST_QUEUE> m_requests; ///< Written by the audio thread, read by computeRequested().
+	std::atomic<unsigned int> m_requestsWritten, m_requestsRead;
+	std::array<ComputedKernel, COMPUTED_QUEUE> m_computed; ///< Written by computeRequested(), read by the audio thread.
+	std::atomic<unsigned int> m_computedWritten, m_computedRead;
 	static FirFilterCache* s_instance;
 	FirFilterCache();
+	/**
+	 * Finds the cache for a filter type and sample rate,
+	 * without creating it. Safe to call from the audio
+	 * thread.
+	 * @return The cache, or nullptr if it has not been prepared.
+	 */
+	FirCoefficientCache* findCache(int filterType, double sampleRate);
+	FirCoefficientSlab* takeSlab();
+	/**
+	 * Copies every kernel computeRequested() has finished
+	 * into the slabs of its cache. Called by
+	 * getCoefficientsFor(), on the audio thread.
+	 */
+	void collectComputed();
+	/**
+	 * Queues a kernel for computeRequested(), unless it is
+	 * queued already. Does nothing if the queue is full, the
+	 * kernel is queued again the next time it is missing.
+	 */
+	void request(FirCoefficientCache* cache, int index);
+	/**
+	 * Computes a kernel and queues it for collectComputed(),
+	 * if there is room.
+	 * @return false if the audio thread has not collected enough of the kernels before it yet.
+	 */
+	bool compute(FirCoefficientCache* cache, int index);
 public:
 	static FirFilterCache* getInstance();
 	~FirFilterCache();
 
-	double* getCoefficientsFor(int filterType, double frequency, double sampleRate);
+	/**
+	 * Works out how many coefficients a filter needs for its
+	 * transition band to be as narrow as its quality asks
+	 * for. The transition band of a windowed sinc gets
+	 * narrower the more coefficients there are, and the
+	 * quality settings make it a fraction of the cutoff, so
+	 * filters with high cutoffs need far fewer.
+	 * @param filterType A bitwise-or combination of window type, filter type and quality from FilterType.
+	 * @param freqFrac The cutoff frequency, as a fraction of the sample rate.
+	 * @return The number of coefficients, between MIN_TAPS and FILTER_KERNEL_SIZE.
+	 */
+	static int chooseTaps(int filterType, double freqFrac);
+	/**
+	 * Computes the kernel for one of the cached cutoffs. This
+	 * is what computeRequested() does for kernels
+	 * getCoefficientsFor() could not find, and it can also be
+	 * used to fill a table of coefficients ahead of time.
+	 * @param filterType A bitwise-or combination of window type, filter type and quality from FilterType.
+	 * @param index The index of the cutoff, from FirCoefficientCache::freqToIndex().
+	 * @param sampleRate The sample rate.
+	 * @param kernel Where to write the FILTER_KERNEL_SIZE coefficients.
+	 * @return How many coefficients in the middle of the kernel are not 0.
+	 */
+	static int computeCoefficients(int filterType, int index, double sampleRate, double* kernel);
+
+	/**
+	 * Creates the cache for a filter type and sample rate,
+	 * so that getCoefficientsFor() can use it. This can be
+	 * called while audio is being processed, but not from
+	 * the audio thread, and only from one thread at a time.
+	 * @param filterType A bitwise-or combination of window type, filter type and quality from FilterType.
+	 * @param sampleRate The sample rate.
+	 * @return The cache, or nullptr if MAX_CACHES have already been created.
+	 */
+	FirCoefficientCache* prepareCache(int filterType, double sampleRate);
+	/**
+	 * Gets coefficients for a filter. If the cutoff has not
+	 * been computed yet, the closest one that has is used
+	 * instead, and the exact one is queued for
+	 * computeRequested(). Every kernel is FILTER_KERNEL_SIZE
+	 * long, but only the middle taps coefficients of it are
+	 * not 0, so that every kernel size has the same delay.
+	 * @param filterType A bitwise-or combination of window type, filter type and quality from FilterType.
+	 * @param frequency The cutoff frequency.
+	 * @param sampleRate The sample rate. Each sample rate has its own cache.
+	 * @param taps Set to how many coefficients are not 0.
+	 * @param slab Set to the slab the coefficients are in, or nullptr if they are in a table and never change. They stay valid for as long as the slab's m_generation stays the same.
+	 * @return A pointer to the first coefficient that is not 0, or nullptr if prepareCache() has not been called for the filter type and sample rate, or none of its cutoffs have been computed yet.
+	 */
+	const double* getCoefficientsFor(int filterType, double frequency, double sampleRate, int& taps, const FirCoefficientSlab*& slab);
+	/**
+	 * Computes the next kernel the audio thread is waiting
+	 * for, if there is one. This should be called
+	 * regularly by one thread other than the audio thread,
+	 * see AtomSynth::FirPrewarmer.
+	 * @return true if a kernel was computed, false if there was nothing to do or no room to put it.
+	 */
+	bool computeRequested();
+	/**
+	 * Computes a kernel ahead of time, so that it is already
+	 * there when the audio thread needs it, unless it has been
+	 * computed before or the cache reads from a table. Only
+	 * COMPUTED_QUEUE kernels can be waiting for the audio
+	 * thread at once, and it only collects them while
+	 * filters are looking up coefficients, so this may have
+	 * to be tried again later. It has to be called from the
+	 * same thread as computeRequested().
+	 * @param cache The cache, from prepareCache().
+	 * @param index The index of the cutoff, from FirCoefficientCache::freqToIndex().
+	 * @return false if there was no room for the kernel yet.
+	 */
+	bool prewarm(FirCoefficientCache* cache, int index);
+	/**
+	 * Gets a kernel that delays the signal by as much as
+	 * every other kernel does, but barely filters it, for
+	 * filters to use until they have coefficients.
+	 * @param taps Set to how many coefficients are not 0.
+	 * @return A pointer to the first coefficient that is not 0.
+	 */
+	const double* getPassThrough(int& taps) {
+		taps = MIN_TAPS;
+		return m_passThrough.data() + (FILTER_KERNEL_SIZE - MIN_TAPS) / 2;
+	}
+	/**
+	 * Makes every lookup for a filter type and sample rate
+	 * read from a complete table, like one loaded from disk
+	 * by AtomSynth::FirCacheFile, so nothing for them ever
+	 * has to be computed. Pointers returned before this stay
+	 * valid until their slabs are evicted as usual. This is
+	 * not thread safe, so it should only be done while audio
+	 * is not being processed.
+	 * @param filterType A bitwise-or combination of window type, filter type and quality from FilterType.
+	 * @param sampleRate The sample rate the table was computed for.
+	 * @param coefficients NUM_FILTERS kernels of FILTER_KERNEL_SIZE coefficients, which has to stay valid for as long as this cache exists.
+	 * @param taps How many coefficients in the middle of each kernel are not 0.
+	 */
+	void attachTable(int filterType, double sampleRate, const double* coefficients, const int* taps);
+	/**
+	 * Deletes every cache that is for a different sample
+	 * rate, since no filter can use them any more, so they
+	 * stop taking up some of the MAX_CACHES. Caches that
+	 * read from a table loaded by attachTable() are kept.
+	 * The slabs of the others go back to being unused, and
+	 * every kernel that was queued for computeRequested()
+	 * is forgotten. This is not thread safe, so it should
+	 * only be done while audio is not being processed and
+	 * nothing is computing kernels, and only while no filter
+	 * that used the old sample rate still exists, which is
+	 * the case while a patch is being loaded again.
+	 * @param sampleRate The sample rate to keep caches for.
+	 */
+	void releaseOtherSampleRates(double sampleRate);
+	/**
+	 * Gets every FirCoefficientCache that has been prepared,
+	 * so that their coefficients can be saved.
+	 */
+	std::vector<FirCoefficientCache*> getCaches();
 };
 
 /**
@@ -64,10 +345,41 @@ public:
  * coefficients are sourced from a cache.
  */
 class CachedFirFilter {
+public:
+	static constexpr int SIZE = FirFilterCache::FILTER_KERNEL_SIZE,
+			PARTITION_SIZE = 128, ///< The partition size used by computeBlock().
+			MAX_DIRECT_TAPS = 128; ///< computeBlock() uses firBlock() instead of FFT convolution for kernels this short.
 private:
-	double* m_coPointer = nullptr;
+	const double* m_coPointer = nullptr;
+	int m_taps = SIZE, m_offset = 0; ///< How many coefficients are used, and which sample of the input the first one lines up with.
+	const FirCoefficientSlab* m_slab = nullptr; ///< The slab m_coPointer points into, or nullptr if it never changes.
+	unsigned int m_generation = 0; ///< The m_generation of m_slab when m_coPointer was looked up.
+	const double* m_convolverCoPointer = nullptr; ///< The coefficients m_convolver was last given.
+	unsigned int m_convolverGeneration = 0; ///< m_generation when m_convolver was last given coefficients.
+	PartitionedConvolver m_convolver = PartitionedConvolver(SIZE, PARTITION_SIZE);
+	/**
+	 * The coefficients a channel was last filtered with by
+	 * computeBlock() or computeCrossfaded().
+	 */
+	struct ChannelState {
+		const double* m_coPointer = nullptr; ///< nullptr if the channel has not been filtered yet.
+		int m_taps = 0, m_offset = 0;
+		const FirCoefficientSlab* m_slab = nullptr;
+		unsigned int m_generation = 0;
+	};
+	std::vector<ChannelState> m_channels;
+	std::vector<double> m_crossfadeBuffer;
+	void rememberChannel(int channel);
+	/**
+	 * Checks if coefficients from a slab still belong to the
+	 * filter they were looked up for.
+	 * @param slab The slab they are in, or nullptr if they are in a table.
+	 * @param generation The m_generation of the slab when they were looked up.
+	 */
+	static bool stillValid(const FirCoefficientSlab* slab, unsigned int generation) {
+		return slab == nullptr || slab->m_generation == generation;
+	}
 public:
-	static constexpr int SIZE = FirFilterCache::FILTER_KERNEL_SIZE;
 	CachedFirFilter() {
 
 	}
@@ -77,11 +389,11 @@ public:
 
 	/**
 	 * Filters the signal in input and writes the
-	 * result to output. Output's size should be at
-	 * least input's size plus the size of the filter,
-	 * since the filter will only calculate the last
-	 * [output.getSize()] samples of the input, but
-	 * needs extra samples because of how FIR filters
+	 * result to output. Input's size should be at
+	 * least output's size plus the size of the filter
+	 * minus one, since the filter will only calculate
+	 * the last [output.getSize()] samples of the input,
+	 * but needs extra samples because of how FIR filters
 	 * work.
 	 * @param input The signal to filter.
 	 * @param output Where to write the resulting signal to.
@@ -101,6 +413,41 @@ public:
 	 */
 	double compute(AtomSynth::AudioBuffer& input, int channel, int startSample);
 
+	/**
+	 * Does the same thing as calling compute(input, c,
+	 * s) for every sample s of output, on channels 0 to
+	 * channels - 1, but using FFT convolution, which
+	 * is much faster. It can only be used when the
+	 * coefficients stay the same for the whole block.
+	 * @param input The signal to filter. Must have at least SIZE - 1 more samples than output.
+	 * @param output Where to write the resulting signal to.
+	 * @param channels How many channels to filter.
+	 */
+	void computeBlock(AtomSynth::AudioBuffer& input, AtomSynth::AudioBuffer& output, int channels);
+
+	/**
+	 * Filters a run of samples from one channel with the
+	 * current coefficients. If they are different to the
+	 * ones the channel was last filtered with, the output
+	 * is crossfaded from the old coefficients to the new
+	 * ones over the run, so that changing the cutoff only
+	 * every few samples does not cause clicks.
+	 * @param channel Which channel this is, to know what it was last filtered with.
+	 * @param history The input. Output sample s uses history[s] to history[s + SIZE - 1], like compute(input, channel, s).
+	 * @param output Where to write the filtered samples.
+	 * @param samples How many samples to filter.
+	 */
+	void computeCrossfaded(int channel, const double* history, double* output, int samples);
+	/**
+	 * Records that every channel was filtered the same way
+	 * as channel 0, for when only channel 0 was computed
+	 * because the input was linked. Otherwise the other
+	 * channels would crossfade from whatever they were last
+	 * filtered with once the input stops being linked.
+	 * @param channels How many channels there are.
+	 */
+	void linkChannels(int channels);
+
 	/**
 	 * Draws a graphical representation of the filter
 	 * coefficients to the console.
@@ -108,15 +455,46 @@ public:
 	void drawToConsole();
 
 	/**
-	 * Sets the coefficients of the filter. If the
-	 * same coefficients were previously requested,
-	 * they will be loaded from the cache instead of
-	 * recalculated.
+	 * Sets the coefficients of the filter. Until they
+	 * have been computed, the closest cutoff that has
+	 * been is used, see FirFilterCache::getCoefficientsFor().
+	 * If nothing has been computed for the filter type yet,
+	 * or its cache has not been prepared (see
+	 * FirFilterCache::prepareCache()), the old coefficients
+	 * are kept, or the signal is passed through if there are
+	 * none.
 	 * @param filterType A bitwise-or combination of window type and filter type from FilterType.
 	 * @param frequency The cutoff frequency.
-	 * @param sampleRate The sample rate (used when the coefficients need to be recomputed.
+	 * @param sampleRate The sample rate. Coefficients are cached separately for each sample rate.
 	 */
 	void set(int filterType, double frequency, double sampleRate);
+
+	/**
+	 * Returns a pointer to the first coefficient. The
+	 * pointer only changes when set() picks a different
+	 * set of coefficients.
+	 * @return A pointer to the first coefficient.
+	 */
+	const double* getCoefficients() {
+		return m_coPointer;
+	}
+	/**
+	 * Returns how many coefficients are actually used.
+	 * Filters with higher cutoffs need fewer of them, see
+	 * FirFilterCache::chooseTaps().
+	 */
+	int getTaps() {
+		return m_taps;
+	}
+	/**
+	 * Returns how far the first coefficient is from the
+	 * start of the SIZE samples that compute() filters.
+	 * The coefficients are always in the middle, so this
+	 * is (SIZE - getTaps()) / 2.
+	 */
+	int getOffset() {
+		return m_offset;
+	}
 };
 
 } /* namespace Adsp */
@@ -0,0 +1,93 @@
+/*
+ * Convolution.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Convolution.h"
+
+#include <algorithm>
+
+namespace Adsp {
+
+PartitionedConvolver::PartitionedConvolver(int kernelSize, int partitionSize) :
+		m_kernelSize(kernelSize),
+		m_partitionSize(partitionSize),
+		m_partitions((kernelSize + partitionSize - 1) / partitionSize),
+		m_fft(partitionSize * 2),
+		m_kernelSpectra(m_partitions * partitionSize * 2),
+		m_sum(partitionSize * 2) {
+}
+
+void PartitionedConvolver::setKernel(const double * kernel) {
+	int fftSize = m_fft.getSize();
+	for (int p = 0; p < m_partitions; p++) {
+		//Each partition goes in the first half of its transform, the second half is left as zeros so the convolution does not wrap around.
+		std::complex<double> * spectrum = &m_kernelSpectra[p * fftSize];
+		int start = p * m_partitionSize, length = std::min(m_partitionSize, m_kernelSize - start);
+		std::fill(spectrum, spectrum + fftSize, 0.0);
+		for (int i = 0; i < length; i++) {
+			spectrum[i] = kernel[start + i];
+		}
+		m_fft.forward(spectrum);
+	}
+}
+
+void PartitionedConvolver::process(const double * first, const double * second, double * firstOutput, double * secondOutput, int samples) {
+	int fftSize = m_fft.getSize(), chunks = (samples + m_partitionSize - 1) / m_partitionSize;
+	//Chunks before the start of the block are needed for the later partitions of the first few chunks.
+	int earlierChunks = m_partitions - 1, spectra = chunks + earlierChunks;
+	if (int(m_inputSpectra.size()) < spectra * fftSize) {
+		m_inputSpectra.resize(spectra * fftSize);
+	}
+
+	//The spectrum of chunk j covers the chunk and the one before it. Overlap-save throws away the
+	//first half of each result, and anything older than the kernel only ever ends up in that half,
+	//so it is left as 0 instead of reading from before the history that has to exist.
+	for (int j = 0; j < spectra; j++) {
+		std::complex<double> * spectrum = &m_inputSpectra[j * fftSize];
+		int start = (j - earlierChunks - 1) * m_partitionSize;
+		int begin = std::max(1, 1 - m_kernelSize - start), end = std::min(fftSize, samples - start);
+		std::fill(spectrum, spectrum + begin, 0.0);
+		if (second == nullptr) {
+			for (int i = begin; i < end; i++) {
+				spectrum[i] = first[start + i];
+			}
+		} else {
+			for (int i = begin; i < end; i++) {
+				spectrum[i] = std::complex<double>(first[start + i], second[start + i]);
+			}
+		}
+		std::fill(spectrum + std::max(end, begin), spectrum + fftSize, 0.0);
+		m_fft.forward(spectrum);
+	}
+
+	double scale = 1.0 / fftSize; //Fft::inverse() does not divide by the size.
+	for (int j = 0; j < chunks; j++) {
+		//Multiply-accumulate with the parts written out, so the compiler doesn't have to handle infinities and NaNs like std::complex does.
+		double * sum = reinterpret_cast<double *>(m_sum.data());
+		std::fill(sum, sum + fftSize * 2, 0.0);
+		for (int p = 0; p < m_partitions; p++) {
+			const double * kernel = reinterpret_cast<const double *>(&m_kernelSpectra[p * fftSize]);
+			const double * input = reinterpret_cast<const double *>(&m_inputSpectra[(j + earlierChunks - p) * fftSize]);
+			for (int i = 0; i < fftSize * 2; i += 2) {
+				sum[i] += input[i] * kernel[i] - input[i + 1] * kernel[i + 1];
+				sum[i + 1] += input[i] * kernel[i + 1] + input[i + 1] * kernel[i];
+			}
+		}
+		m_fft.inverse(m_sum.data());
+
+		int start = j * m_partitionSize, length = std::min(m_partitionSize, samples - start);
+		const std::complex<double> * result = &m_sum[m_partitionSize];
+		for (int i = 0; i < length; i++) {
+			firstOutput[start + i] = result[i].real() * scale;
+		}
+		if (second != nullptr) {
+			for (int i = 0; i < length; i++) {
+				secondOutput[start + i] = result[i].imag() * scale;
+			}
+		}
+	}
+}
+
+} /* namespace Adsp */
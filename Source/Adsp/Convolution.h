@@ -0,0 +1,88 @@
+/*
+ * Convolution.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_CONVOLUTION_H_
+#define SOURCE_ADSP_CONVOLUTION_H_
+
+#include <complex>
+#include <vector>
+
+#include "Fft.h"
+
+namespace Adsp {
+/**
+ * @defgroup convolution
+ * @ingroup Adsp
+ * Convolution with long kernels, done in the frequency
+ * domain.
+ * @{
+ */
+
+/**
+ * Convolves signals with a fixed kernel using uniformly
+ * partitioned overlap-save. The kernel is split into
+ * partitions of getPartitionSize() samples, and the signal
+ * into chunks of the same size. Each chunk of output is the
+ * sum of the spectrum of each partition multiplied by the
+ * spectrum of an earlier chunk of input, so every chunk of
+ * input only has to be transformed once, no matter how many
+ * partitions there are. For a 512 tap kernel, this is
+ * around 20 times less work per sample than computing the
+ * convolution directly.
+ *
+ * Since the filter is real, two signals can be convolved
+ * at once by putting one in the real part of the transform
+ * and the other in the imaginary part.
+ */
+class PartitionedConvolver {
+private:
+	int m_kernelSize, m_partitionSize, m_partitions;
+	Fft m_fft;
+	std::vector<std::complex<double>> m_kernelSpectra; ///< One spectrum for each partition of the kernel, one after the other.
+	std::vector<std::complex<double>> m_inputSpectra; ///< One spectrum for each chunk of input in the current block, one after the other.
+	std::vector<std::complex<double>> m_sum;
+public:
+	/**
+	 * Prepares to convolve with kernels of a given size. The
+	 * kernel starts out as silence.
+	 * @param kernelSize How many samples long kernels are.
+	 * @param partitionSize How many samples are in each partition. Must be a power of 2.
+	 */
+	PartitionedConvolver(int kernelSize, int partitionSize);
+
+	int getKernelSize() const {
+		return m_kernelSize;
+	}
+	int getPartitionSize() const {
+		return m_partitionSize;
+	}
+
+	/**
+	 * Changes the kernel. This does one fourier transform of
+	 * twice getPartitionSize() points per partition, so it
+	 * should only be done when the kernel actually changes.
+	 * @param kernel getKernelSize() samples, the first of which is applied to the newest input.
+	 */
+	void setKernel(const double * kernel);
+	/**
+	 * Convolves one or two signals with the kernel. Output
+	 * sample i is the sum of kernel[j] * input[i - j], so
+	 * getKernelSize() - 1 samples from before the start of
+	 * each input have to be readable.
+	 * @param first The first signal.
+	 * @param second The second signal, or nullptr if there is only one.
+	 * @param firstOutput Where to put the first convolved signal.
+	 * @param secondOutput Where to put the second convolved signal. Ignored if second is nullptr.
+	 * @param samples How many samples of output to compute.
+	 */
+	void process(const double * first, const double * second, double * firstOutput, double * secondOutput, int samples);
+};
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_CONVOLUTION_H_ */
@@ -0,0 +1,139 @@
+/*
+ * Cpu.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Cpu.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ADSP_CPU_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+namespace Adsp {
+
+#if defined(ADSP_CPU_X86) && defined(_MSC_VER)
+static SimdLevel detectMsvc() {
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0,
+			fma = (info[2] & (1 << 12)) != 0,
+			osxsave = (info[2] & (1 << 27)) != 0,
+			avx = (info[2] & (1 << 28)) != 0;
+	bool avx2 = false, avx512 = false;
+	if (maxLeaf >= 7) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+		avx512 = (info[1] & (1 << 16)) != 0;
+	}
+	//The OS also has to save the wider registers when switching threads.
+	unsigned long long xcr0 = (osxsave) ? _xgetbv(0) : 0;
+	bool osAvx = (xcr0 & 0x6) == 0x6, osAvx512 = (xcr0 & 0xE6) == 0xE6;
+
+	if (avx512 && osAvx512)
+		return SimdLevel::AVX512;
+	if (avx2 && fma && osAvx)
+		return SimdLevel::AVX2;
+	if (avx && osAvx)
+		return SimdLevel::AVX;
+	if (sse2)
+		return SimdLevel::SSE2;
+	return SimdLevel::SCALAR;
+}
+#endif
+
+static SimdLevel detect() {
+#if defined(ADSP_CPU_X86) && defined(_MSC_VER)
+	return detectMsvc();
+#elif defined(ADSP_CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+	//These check that the OS supports the wider registers too.
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return SimdLevel::AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return SimdLevel::AVX2;
+	if (__builtin_cpu_supports("avx"))
+		return SimdLevel::AVX;
+	if (__builtin_cpu_supports("sse2"))
+		return SimdLevel::SSE2;
+	return SimdLevel::SCALAR;
+#else
+	return SimdLevel::SCALAR;
+#endif
+}
+
+/**
+ * Reads ADSP_SIMD_LEVEL, if it is set.
+ * @return The requested level, or -1 if there is none.
+ */
+static int readEnvironmentLevel() {
+	const char * value = std::getenv("ADSP_SIMD_LEVEL");
+	if (value == nullptr)
+		return -1;
+	for (int level = int(SimdLevel::SCALAR); level <= int(SimdLevel::AVX512); level++) {
+		const char * name = getSimdLevelName(SimdLevel(level));
+		bool match = std::strlen(name) == std::strlen(value);
+		for (int i = 0; match && name[i] != '\0'; i++) {
+			match = (name[i] | 0x20) == (value[i] | 0x20); //Case insensitive.
+		}
+		if (match)
+			return level;
+	}
+	return -1;
+}
+
+/**
+ * The level set by forceSimdLevel(), or -1 if there is none.
+ * Starts out as whatever ADSP_SIMD_LEVEL asks for.
+ */
+static std::atomic<int> & getForcedLevel() {
+	static std::atomic<int> forced(std::min(readEnvironmentLevel(), int(detectSimdLevel())));
+	return forced;
+}
+
+SimdLevel detectSimdLevel() {
+	static const SimdLevel detected = detect();
+	return detected;
+}
+
+SimdLevel getSimdLevel() {
+	int forced = getForcedLevel().load(std::memory_order_relaxed);
+	return (forced >= 0) ? SimdLevel(forced) : detectSimdLevel();
+}
+
+void forceSimdLevel(SimdLevel level) {
+	getForcedLevel().store(std::min(int(level), int(detectSimdLevel())), std::memory_order_relaxed);
+}
+
+void clearForcedSimdLevel() {
+	getForcedLevel().store(-1, std::memory_order_relaxed);
+}
+
+const char * getSimdLevelName(SimdLevel level) {
+	switch (level) {
+	case SimdLevel::SCALAR:
+		return "Scalar";
+	case SimdLevel::SSE2:
+		return "SSE2";
+	case SimdLevel::AVX:
+		return "AVX";
+	case SimdLevel::AVX2:
+		return "AVX2";
+	case SimdLevel::AVX512:
+		return "AVX512";
+	}
+	return "Unknown";
+}
+
+} /* namespace Adsp */
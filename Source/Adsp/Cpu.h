@@ -0,0 +1,86 @@
+/*
+ * Cpu.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_CPU_H_
+#define SOURCE_ADSP_CPU_H_
+
+//Kernels that have a version for each level mark each version with the
+//instructions it uses. GCC and Clang only let a function use newer
+//instructions if it is marked as such. MSVC lets any function use them,
+//it is up to getSimdLevel() to only pick them when the CPU has them.
+#if defined(__GNUC__) || defined(__clang__)
+#define ADSP_TARGET_AVX __attribute__((target("avx")))
+#define ADSP_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define ADSP_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define ADSP_TARGET_AVX
+#define ADSP_TARGET_AVX2
+#define ADSP_TARGET_AVX512
+#endif
+
+namespace Adsp {
+/**
+ * @defgroup cpu
+ * @ingroup Adsp
+ * Figures out which SIMD instructions the computer running
+ * the synth supports. Kernels that have versions for several
+ * instruction sets (see @ref vector) use getSimdLevel() to
+ * pick one. The level can be forced lower for testing, either
+ * with forceSimdLevel() or by setting the ADSP_SIMD_LEVEL
+ * environment variable to scalar, sse2, avx, avx2 or avx512
+ * before starting the synth.
+ * @{
+ */
+
+/**
+ * Sets of SIMD instructions, from least to most capable.
+ * Each level includes everything from the levels below it.
+ */
+enum class SimdLevel {
+	SCALAR = 0, ///< No SIMD, plain C++.
+	SSE2 = 1, ///< 2 doubles at a time. Every x86-64 CPU has this.
+	AVX = 2, ///< 4 doubles at a time.
+	AVX2 = 3, ///< 4 doubles at a time, with fused multiply-add.
+	AVX512 = 4, ///< 8 doubles at a time.
+};
+
+/**
+ * Gets the most capable level that both the CPU and the
+ * operating system support. This is only figured out once.
+ * @return The best SimdLevel this computer can run.
+ */
+SimdLevel detectSimdLevel();
+/**
+ * Gets the level kernels should use right now. This is
+ * detectSimdLevel(), unless a lower level has been forced.
+ * @return The SimdLevel to use.
+ */
+SimdLevel getSimdLevel();
+/**
+ * Makes kernels use a particular level, e.g. to compare
+ * their results or speed across levels. Levels the
+ * computer does not support are lowered to
+ * detectSimdLevel(), so this can never cause a crash.
+ * @param level The SimdLevel to use from now on.
+ */
+void forceSimdLevel(SimdLevel level);
+/**
+ * Undoes forceSimdLevel(), including any level set
+ * through the ADSP_SIMD_LEVEL environment variable.
+ */
+void clearForcedSimdLevel();
+/**
+ * Gets a readable name for a level, for logging.
+ * @param level The SimdLevel to name.
+ * @return E.G. "AVX2".
+ */
+const char * getSimdLevelName(SimdLevel level);
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_CPU_H_ */
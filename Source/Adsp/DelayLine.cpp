@@ -0,0 +1,110 @@
+/*
+ * DelayLine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "DelayLine.h"
+
+#include <algorithm>
+
+namespace Adsp {
+
+/**
+ * 4 point Hermite interpolation between before and after.
+ * newer and older are the samples on either side of them.
+ */
+static double hermite(double newer, double before, double after, double older, double blend) {
+	double c1 = 0.5 * (after - newer);
+	double c2 = newer - 2.5 * before + 2.0 * after - 0.5 * older;
+	double c3 = 0.5 * (older - newer) + 1.5 * (before - after);
+	return ((c3 * blend + c2) * blend + c1) * blend + before;
+}
+
+DelayLine::DelayLine(int channels, int minimumSize) :
+		m_channels(channels) {
+	m_size = 1;
+	while (m_size < minimumSize) {
+		m_size *= 2;
+	}
+	m_mask = m_size - 1;
+	m_samples.resize(m_size * m_channels, 0.0f);
+	m_allpassOutputs.resize(m_channels, 0.0);
+}
+
+void DelayLine::clear() {
+	std::fill(m_samples.begin(), m_samples.end(), 0.0f);
+	std::fill(m_allpassOutputs.begin(), m_allpassOutputs.end(), 0.0);
+}
+
+double DelayLine::read(int channel, int offset, double delay, int interpolation) {
+	const float * samples = &m_samples[channel * m_size];
+	if (interpolation == DelayInterpolation::ALLPASS) {
+		//Keeping the fractional part between 0.5 and 1.5 keeps the filter's pole away from -1.
+		int whole = int(delay - 0.5);
+		double fraction = delay - whole, coefficient = (1.0 - fraction) / (1.0 + fraction);
+		int position = m_writePosition + offset - whole;
+		double & previous = m_allpassOutputs[channel];
+		previous = coefficient * (samples[position & m_mask] - previous) + samples[(position - 1) & m_mask];
+		return previous;
+	}
+	int whole = int(delay);
+	double fraction = delay - whole;
+	int position = m_writePosition + offset - whole;
+	double before = samples[position & m_mask], after = samples[(position - 1) & m_mask];
+	if (interpolation == DelayInterpolation::LINEAR) {
+		return before + (after - before) * fraction;
+	}
+	return hermite(samples[(position + 1) & m_mask], before, after, samples[(position - 2) & m_mask], fraction);
+}
+
+void DelayLine::readBlock(int channel, int offset, double delay, int interpolation, double * output, int samples) {
+	if (interpolation == DelayInterpolation::ALLPASS) {
+		//Every output depends on the one before it, so there is nothing to gain from doing them together.
+		for (int s = 0; s < samples; s++) {
+			output[s] = read(channel, offset + s, delay, interpolation);
+		}
+		return;
+	}
+	const float * line = &m_samples[channel * m_size];
+	int whole = int(delay);
+	double fraction = delay - whole;
+	int s = 0;
+	while (s < samples) {
+		int position = (m_writePosition + offset + s - whole) & m_mask;
+		//Read straight from memory until one of the 4 samples used wraps around, which the compiler can vectorize.
+		int run = std::min(samples - s, m_size - 1 - position);
+		if (position < 2 || run <= 0) {
+			output[s] = read(channel, offset + s, delay, interpolation);
+			s++;
+			continue;
+		}
+		const float * before = line + position;
+		double * out = output + s;
+		if (interpolation == DelayInterpolation::LINEAR) {
+			for (int i = 0; i < run; i++) {
+				out[i] = before[i] + (double(before[i - 1]) - before[i]) * fraction;
+			}
+		} else {
+			for (int i = 0; i < run; i++) {
+				out[i] = hermite(before[i + 1], before[i], before[i - 1], before[i - 2], fraction);
+			}
+		}
+		s += run;
+	}
+}
+
+void DelayLine::writeBlock(int channel, int offset, const double * input, int samples) {
+	float * line = &m_samples[channel * m_size];
+	int s = 0;
+	while (s < samples) {
+		int position = (m_writePosition + offset + s) & m_mask;
+		int run = std::min(samples - s, m_size - position);
+		for (int i = 0; i < run; i++) {
+			line[position + i] = float(input[s + i]);
+		}
+		s += run;
+	}
+}
+
+} /* namespace Adsp */
@@ -0,0 +1,138 @@
+/*
+ * DelayLine.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_DELAYLINE_H_
+#define SOURCE_ADSP_DELAYLINE_H_
+
+#include <vector>
+
+namespace Adsp {
+/**
+ * @defgroup delayLine
+ * @ingroup Adsp
+ * A circular buffer for delay effects, with fractional
+ * delay times.
+ * @{
+ */
+
+/**
+ * How DelayLine reads between samples.
+ */
+namespace DelayInterpolation {
+	static constexpr int LINEAR = 0, ///< Cheapest, but it dulls high frequencies when the delay is between samples.
+			CUBIC = 1, ///< 4 point Hermite interpolation. Much less dulling, and smooth when the delay is modulated.
+			ALLPASS = 2; ///< A first order allpass filter. No dulling at all, but it has to be run one sample at a time, and it smears when the delay changes quickly.
+}
+
+/**
+ * Stores the last few seconds of one or more channels of
+ * a signal. The length is always a power of two, so
+ * wrapping around the end is just a bitwise and. Samples
+ * are stored as floats, which is plenty for a delay.
+ *
+ * Each block, the delay line is read from and written to
+ * with offsets from 0 to the block size, then advance()
+ * is called with the block size. Delays are measured in
+ * samples from the sample being written, and have to be
+ * at least MIN_DELAY.
+ */
+class DelayLine {
+public:
+	static constexpr double MIN_DELAY = 2.0; ///< Cubic interpolation needs one sample newer than the delay, which has to be written already.
+private:
+	std::vector<float> m_samples;
+	std::vector<double> m_allpassOutputs; ///< The last output of the allpass filter on each channel.
+	int m_size, m_mask, m_channels, m_writePosition = 0;
+public:
+	/**
+	 * Creates a delay line full of zeros.
+	 * @param channels How many channels to store.
+	 * @param minimumSize How many samples to store in each channel. This is rounded up to a power of two.
+	 */
+	DelayLine(int channels, int minimumSize);
+
+	int getSize() const {
+		return m_size;
+	}
+	int getChannels() const {
+		return m_channels;
+	}
+	/**
+	 * Gets the longest delay that can be read.
+	 * @return The longest delay, in samples.
+	 */
+	double getMaxDelay() const {
+		return m_size - 2.0; //Cubic interpolation needs one sample older than the delay.
+	}
+	/**
+	 * Gets how many samples readBlock() can read before it
+	 * would need the samples that are being written in the
+	 * same block.
+	 * @param delay The delay, in samples.
+	 * @return How many samples to read and write at a time.
+	 */
+	static int getMaxBlock(double delay) {
+		return int(delay) - 1;
+	}
+
+	/**
+	 * Sets every sample back to zero.
+	 */
+	void clear();
+
+	/**
+	 * Reads one sample.
+	 * @param channel Which channel to read.
+	 * @param offset Which sample of the current block is being computed.
+	 * @param delay How many samples to delay by, between MIN_DELAY and getMaxDelay().
+	 * @param interpolation One of DelayInterpolation.
+	 * @return The delayed sample.
+	 */
+	double read(int channel, int offset, double delay, int interpolation);
+	/**
+	 * Reads a block of samples, all with the same delay. This
+	 * is much faster than read() for linear and cubic
+	 * interpolation. At most getMaxBlock() samples should be
+	 * read before the same samples are written.
+	 * @param channel Which channel to read.
+	 * @param offset Which sample of the current block to start at.
+	 * @param delay How many samples to delay by, between MIN_DELAY and getMaxDelay().
+	 * @param interpolation One of DelayInterpolation.
+	 * @param output Where to put the delayed samples.
+	 * @param samples How many samples to read.
+	 */
+	void readBlock(int channel, int offset, double delay, int interpolation, double * output, int samples);
+	/**
+	 * Writes one sample.
+	 * @param channel Which channel to write.
+	 * @param offset Which sample of the current block is being written.
+	 * @param value The value to write.
+	 */
+	void write(int channel, int offset, double value) {
+		m_samples[channel * m_size + ((m_writePosition + offset) & m_mask)] = float(value);
+	}
+	/**
+	 * Writes a block of samples.
+	 * @param channel Which channel to write.
+	 * @param offset Which sample of the current block to start at.
+	 * @param input The samples to write.
+	 * @param samples How many samples to write.
+	 */
+	void writeBlock(int channel, int offset, const double * input, int samples);
+	/**
+	 * Moves on to the next block.
+	 * @param samples The size of the block that was just written.
+	 */
+	void advance(int samples) {
+		m_writePosition = (m_writePosition + samples) & m_mask;
+	}
+};
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_DELAYLINE_H_ */
@@ -0,0 +1,145 @@
+/*
+ * Envelope.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Envelope.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Interpolation.h"
+
+namespace Adsp {
+
+constexpr double INFINITE_TIME = std::numeric_limits<double>::infinity();
+
+void SegmentEnvelope::setTimes(double delay, double attack, double hold, double decay, double release) {
+	m_ends[0] = delay;
+	m_ends[1] = m_ends[0] + attack;
+	m_ends[2] = m_ends[1] + hold;
+	m_ends[3] = m_ends[2] + decay;
+	//Segments with no length are never rendered, so their inverses are never used.
+	m_inverseAttack = (attack > 0.0) ? 1.0 / attack : 0.0;
+	m_inverseDecay = (decay > 0.0) ? 1.0 / decay : 0.0;
+	m_releaseTime = release;
+	m_inverseRelease = (release > 0.0) ? 1.0 / release : 0.0;
+}
+
+void SegmentEnvelope::findSegment(double time) {
+	//Released times are negative, so the segments while releasing have to exclude 0. (Held times include it.)
+	constexpr double SMALLEST_RELEASED = std::numeric_limits<double>::denorm_min();
+	m_sign = (m_releasing) ? -1.0 : 1.0;
+	if (m_releasing) {
+		double releaseEnd = m_releaseStart + m_releaseTime;
+		if (time < releaseEnd) {
+			m_segment = EnvelopeSegment::RELEASE;
+			m_segmentStart = SMALLEST_RELEASED; //Times from before the release are clamped to the start of it.
+			m_segmentEnd = releaseEnd;
+		} else {
+			m_segment = EnvelopeSegment::FINISHED;
+			m_segmentStart = std::max(releaseEnd, SMALLEST_RELEASED);
+			m_segmentEnd = INFINITE_TIME;
+		}
+	} else {
+		int segment = EnvelopeSegment::DELAY;
+		while (segment < EnvelopeSegment::SUSTAIN && !(time < m_ends[segment])) {
+			segment++;
+		}
+		m_segment = segment;
+		m_segmentStart = (segment == EnvelopeSegment::DELAY) ? 0.0 : m_ends[segment - 1];
+		m_segmentEnd = (segment == EnvelopeSegment::SUSTAIN) ? INFINITE_TIME : m_ends[segment];
+	}
+}
+
+int SegmentEnvelope::countInSegment(const double * time, int samples) const {
+	//Most blocks never leave their segment, so check every sample without branching first, which the compiler can vectorize.
+	double sign = m_sign, start = m_segmentStart, end = m_segmentEnd;
+	double outside = 0.0; //Counted as a double, since compilers won't vectorize loops that mix doubles and integers.
+	for (int i = 0; i < samples; i++) {
+		double signedTime = time[i] * sign;
+		outside += (signedTime >= start && signedTime < end) ? 0.0 : 1.0;
+	}
+	if (outside == 0.0) {
+		return samples;
+	}
+	int count = 0;
+	while (count < samples) {
+		double signedTime = time[count] * sign;
+		if (!(signedTime >= start && signedTime < end)) {
+			break;
+		}
+		count++;
+	}
+	return count;
+}
+
+void SegmentEnvelope::renderSegment(const double * time, double * output, int samples) {
+	switch (m_segment) {
+	case EnvelopeSegment::DELAY:
+	case EnvelopeSegment::FINISHED:
+		std::fill(output, output + samples, -1.0);
+		break;
+	case EnvelopeSegment::ATTACK:
+		for (int s = 0; s < samples; s++) {
+			double blend = (std::fabs(time[s]) - m_ends[0]) * m_inverseAttack;
+			output[s] = fastEnvelopeInterp(blend, m_attackShape) * m_holdLevel * 2.0 - 1.0;
+		}
+		break;
+	case EnvelopeSegment::HOLD:
+		std::fill(output, output + samples, m_holdLevel * 2.0 - 1.0);
+		break;
+	case EnvelopeSegment::DECAY:
+		for (int s = 0; s < samples; s++) {
+			double blend = 1.0 - (std::fabs(time[s]) - m_ends[2]) * m_inverseDecay;
+			output[s] = fastEnvelopeInterp(blend, m_decayShape) * 2.0 * (m_holdLevel - m_sustainLevel) - 1.0 + m_sustainLevel * 2.0;
+		}
+		break;
+	case EnvelopeSegment::SUSTAIN:
+		std::fill(output, output + samples, m_sustainLevel * 2.0 - 1.0);
+		break;
+	case EnvelopeSegment::RELEASE:
+		for (int s = 0; s < samples; s++) {
+			double blend = std::min(1.0, 1.0 - (std::fabs(time[s]) - m_releaseStart) * m_inverseRelease);
+			output[s] = fastEnvelopeInterp(blend, m_releaseShape) * m_releaseLevel - 1.0;
+		}
+		break;
+	}
+}
+
+bool SegmentEnvelope::render(const double * time, double * output, int samples) {
+	int firstSegment = m_segment;
+	bool changed = false;
+	int s = 0;
+	while (s < samples) {
+		bool released = time[s] < 0.0;
+		double position = std::fabs(time[s]);
+		if (released != m_releasing) {
+			if (released) {
+				//The first released sample still comes from the old segment, and sets the level that the release starts from.
+				findSegment(position);
+				renderSegment(&position, output + s, 1);
+				m_releasing = true;
+				m_releaseStart = position;
+				m_releaseLevel = output[s] + 1.0;
+				findSegment(position);
+				changed = true;
+				s++;
+				continue;
+			}
+			m_releasing = false; //The note was played again.
+		}
+		findSegment(position);
+		changed = changed || (m_segment != firstSegment);
+
+		//Every sample until the time leaves the segment can be rendered together.
+		int end = s + 1 + countInSegment(time + s + 1, samples - s - 1);
+		renderSegment(time + s, output + s, end - s);
+		s = end;
+	}
+	return changed;
+}
+
+} /* namespace Adsp */
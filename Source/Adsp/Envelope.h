@@ -0,0 +1,148 @@
+/*
+ * Envelope.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_ENVELOPE_H_
+#define SOURCE_ADSP_ENVELOPE_H_
+
+namespace Adsp {
+/**
+ * @defgroup envelope
+ * @ingroup Adsp
+ * The envelope used by EnvelopeAtom, split into segments
+ * so that it can be rendered a whole segment at a time.
+ * @{
+ */
+
+/**
+ * The segments of a SegmentEnvelope, in the order they are
+ * played.
+ */
+namespace EnvelopeSegment {
+	static constexpr int DELAY = 0, ///< Silent, before the attack starts.
+			ATTACK = 1, ///< Rising from silence to the hold level.
+			HOLD = 2, ///< Staying at the hold level.
+			DECAY = 3, ///< Falling from the hold level to the sustain level.
+			SUSTAIN = 4, ///< Staying at the sustain level until the note is released.
+			RELEASE = 5, ///< Falling from wherever the envelope was released to silence.
+			FINISHED = 6; ///< Silent, after the release.
+}
+
+/**
+ * A delay / attack / hold / decay / sustain / release
+ * envelope, driven by a time input. (Positive while the note
+ * is held, negative once it is released, see InputAtom.) The
+ * envelope remembers which segment it is in, so it only has
+ * to check the time against the two ends of that segment
+ * every sample. Flat segments are filled in one go, and the
+ * others only need one multiply and a fastEnvelopeInterp()
+ * per sample. Outputs go from -1 (silent) to 1.
+ */
+class SegmentEnvelope {
+private:
+	double m_ends[4] = { 0.0, 0.0, 0.0, 0.0 }; ///< When the delay, attack, hold and decay segments end.
+	double m_inverseAttack = 0.0, m_inverseDecay = 0.0, m_releaseTime = 0.0, m_inverseRelease = 0.0;
+	double m_holdLevel = 1.0, m_sustainLevel = 1.0;
+	double m_attackShape = 0.0, m_decayShape = 0.0, m_releaseShape = 0.0;
+
+	int m_segment = EnvelopeSegment::DELAY;
+	double m_segmentStart = 0.0, m_segmentEnd = 0.0; ///< The range of times that stay in m_segment, after multiplying them by m_sign.
+	double m_sign = 1.0; ///< -1 while releasing, so that released times are positive too.
+	bool m_releasing = false;
+	double m_releaseStart = 0.0, m_releaseLevel = 0.0;
+
+	/**
+	 * Finds the segment that a time is in, and updates
+	 * m_segment, m_segmentStart and m_segmentEnd.
+	 */
+	void findSegment(double time);
+	/**
+	 * Counts how many samples at the start of a block stay
+	 * in m_segment.
+	 */
+	int countInSegment(const double * time, int samples) const;
+	/**
+	 * Renders samples that are all in m_segment.
+	 */
+	void renderSegment(const double * time, double * output, int samples);
+public:
+	SegmentEnvelope() {
+	}
+
+	/**
+	 * Sets how long each segment is, in seconds. This can be
+	 * changed at any time, the envelope will jump to
+	 * wherever the time input is in the new envelope.
+	 */
+	void setTimes(double delay, double attack, double hold, double decay, double release);
+	/**
+	 * Sets the levels the envelope holds at, from 0 to 1.
+	 * @param hold The level at the top of the attack.
+	 * @param sustain The level held while the note is held after the decay.
+	 */
+	void setLevels(double hold, double sustain) {
+		m_holdLevel = hold;
+		m_sustainLevel = sustain;
+	}
+	/**
+	 * Sets the shapes of the segments that are not flat. See
+	 * fastEnvelopeInterp().
+	 */
+	void setShapes(double attack, double decay, double release) {
+		m_attackShape = attack;
+		m_decayShape = decay;
+		m_releaseShape = release;
+	}
+
+	/**
+	 * Renders a block of the envelope.
+	 * @param time The time input, one value for each sample. Negative values mean the note has been released.
+	 * @param output Where to put the envelope.
+	 * @param samples How many samples to render.
+	 * @return True if the envelope moved to a different segment during the block.
+	 */
+	bool render(const double * time, double * output, int samples);
+
+	/**
+	 * Gets the segment the envelope was in at the end of the
+	 * last render().
+	 * @return One of EnvelopeSegment.
+	 */
+	int getSegment() const {
+		return m_segment;
+	}
+	/**
+	 * Checks if the current segment is flat, meaning every
+	 * sample of it has the same value, as long as the levels
+	 * don't change.
+	 * @return True if the envelope is in the delay, hold, sustain or finished segment.
+	 */
+	bool isFlat() const {
+		return m_segment == EnvelopeSegment::DELAY || m_segment == EnvelopeSegment::HOLD || m_segment == EnvelopeSegment::SUSTAIN
+				|| m_segment == EnvelopeSegment::FINISHED;
+	}
+	bool isReleasing() const {
+		return m_releasing;
+	}
+	/**
+	 * Gets the (positive) time that the note was released at.
+	 */
+	double getReleaseStart() const {
+		return m_releaseStart;
+	}
+	/**
+	 * Gets the level the envelope was at when it was
+	 * released, from 0 to 2.
+	 */
+	double getReleaseLevel() const {
+		return m_releaseLevel;
+	}
+};
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_ENVELOPE_H_ */
@@ -0,0 +1,145 @@
+/*
+ * FastMath.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_FASTMATH_H_
+#define SOURCE_ADSP_FASTMATH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace Adsp {
+/**
+ * @defgroup fastMath
+ * @ingroup Adsp
+ * Replacements for the transcendental functions in cmath,
+ * for code that runs every sample. They are polynomials
+ * with no branches or table lookups, so they inline well
+ * and the compiler can vectorize loops that use them. Each
+ * one takes its accuracy as a template parameter, from
+ * Accuracy.
+ * @{
+ */
+
+/**
+ * How accurate the functions in @ref fastMath should be.
+ */
+namespace Accuracy {
+	static constexpr int FAST = 0, ///< About 1e-8, which is more than enough for anything that is only listened to.
+			PRECISE = 1; ///< About 1e-15, close to what cmath gives.
+}
+
+/**
+ * Coefficients of x * P(x^2), a polynomial that matches
+ * sin(pi * x) between -0.5 and 0.5. (Chebyshev fits.)
+ */
+constexpr double SIN_PI_FAST[5] = { 3.141592640077203, -5.167710076668316, 2.5500773865289372, -0.5982904112836939, 0.07765591227685842 };
+constexpr double SIN_PI_PRECISE[8] = { 3.1415926535897927, -5.167712780049818, 2.5501640398632754, -0.5992645288539113, 0.08214587915911954,
+		-0.00737036658558759, 0.00046599442694486966, -2.1143030125171367e-05 };
+/**
+ * Coefficients of a polynomial that matches 2^x between
+ * -0.5 and 0.5. (Chebyshev fits.)
+ */
+constexpr double EXP2_FAST[7] = { 1.0, 0.6931472067028321, 0.24022650922288827, 0.05550327226670944, 0.00961805667852609, 0.0013400428177419153,
+		0.0001546144469646172 };
+constexpr double EXP2_PRECISE[12] = { 1.0, 0.6931471805599452, 0.24022650695910666, 0.055504108664826274, 0.009618129107385725,
+		0.0013333558144771928, 0.00015403530696571948, 1.5252736320058628e-05, 1.3215328043422377e-06, 1.0176688520064848e-07,
+		7.090282845676875e-09, 4.701588631401557e-10 };
+
+/**
+ * Rounds to the nearest integer, without a function call.
+ * Adding 1.5 * 2^52 pushes every bit after the decimal
+ * point out of the double. Only works for values smaller
+ * than 2^51.
+ */
+constexpr double roundToInteger(double value) {
+	return (value + 6755399441055744.0) - 6755399441055744.0;
+}
+
+/**
+ * Computes sin(pi * x).
+ * @param x Any number smaller than 2^51.
+ * @return sin(pi * x)
+ */
+template<int ACCURACY = Accuracy::PRECISE>
+constexpr double fastSinPi(double x) {
+	x -= 2.0 * roundToInteger(x * 0.5); //Between -1 and 1.
+	//sin(pi * x) is symmetric around 0.5 and -0.5, so this folds the rest of -1 to 1 into -0.5 to 0.5.
+	x = std::max(std::min(x, 1.0 - x), -1.0 - x);
+	double x2 = x * x;
+	if (ACCURACY == Accuracy::FAST) {
+		const double * c = SIN_PI_FAST;
+		return x * (c[0] + x2 * (c[1] + x2 * (c[2] + x2 * (c[3] + x2 * c[4]))));
+	}
+	const double * c = SIN_PI_PRECISE;
+	return x * (c[0] + x2 * (c[1] + x2 * (c[2] + x2 * (c[3] + x2 * (c[4] + x2 * (c[5] + x2 * (c[6] + x2 * c[7])))))));
+}
+
+/**
+ * Computes cos(pi * x).
+ * @param x Any number smaller than 2^51.
+ * @return cos(pi * x)
+ */
+template<int ACCURACY = Accuracy::PRECISE>
+constexpr double fastCosPi(double x) {
+	return fastSinPi<ACCURACY>(x + 0.5);
+}
+
+/**
+ * Computes 2^x.
+ * @param x The exponent. Anything outside of -1022 to 1023 is clamped to that range.
+ * @return 2^x
+ */
+template<int ACCURACY = Accuracy::PRECISE>
+inline double fastExp2(double x) {
+	x = std::max(-1022.0, std::min(1023.0, x));
+	//Same trick as roundToInteger(), but the rounded value is also left in the low bits of shifted.
+	double shifted = x + 6755399441055744.0;
+	double whole = shifted - 6755399441055744.0, f = x - whole, fraction;
+	if (ACCURACY == Accuracy::FAST) {
+		const double * c = EXP2_FAST;
+		fraction = c[0] + f * (c[1] + f * (c[2] + f * (c[3] + f * (c[4] + f * (c[5] + f * c[6])))));
+	} else {
+		const double * c = EXP2_PRECISE;
+		fraction = c[0] + f * (c[1] + f * (c[2] + f * (c[3] + f * (c[4] + f * (c[5] + f * (c[6] + f * (c[7] + f * (c[8]
+				+ f * (c[9] + f * (c[10] + f * c[11]))))))))));
+	}
+	//2^whole can be written straight into the exponent bits of a double. Only the low bits of shifted survive the shift.
+	std::int64_t bits;
+	std::memcpy(&bits, &shifted, sizeof(bits));
+	bits = (bits + 1023) << 52;
+	double scale;
+	std::memcpy(&scale, &bits, sizeof(scale));
+	return fraction * scale;
+}
+
+/**
+ * Computes e^x.
+ * @param x The exponent. Anything that would overflow is clamped.
+ * @return e^x
+ */
+template<int ACCURACY = Accuracy::PRECISE>
+inline double fastExp(double x) {
+	return fastExp2<ACCURACY>(x * 1.4426950408889634); //1 / ln(2)
+}
+
+/**
+ * Computes tanh(x), as 1 - 2 / (e^(2x) + 1).
+ * @param x Any number.
+ * @return tanh(x)
+ */
+template<int ACCURACY = Accuracy::PRECISE>
+inline double fastTanh(double x) {
+	//tanh is 1 to double precision long before 20, and clamping keeps e^(2x) from overflowing.
+	double e = fastExp2<ACCURACY>(std::max(-20.0, std::min(20.0, x)) * 2.8853900817779268); //2 / ln(2)
+	return 1.0 - 2.0 / (e + 1.0);
+}
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_FASTMATH_H_ */
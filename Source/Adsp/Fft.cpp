@@ -0,0 +1,71 @@
+/*
+ * Fft.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Fft.h"
+
+#include <cmath>
+#include <utility>
+
+namespace Adsp {
+
+Fft::Fft(int size) :
+		m_size(size),
+		m_twiddles(size / 2),
+		m_reversed(size) {
+	for (int k = 0; k < size / 2; k++) {
+		m_twiddles[k] = std::polar(1.0, -2.0 * M_PI * k / size);
+	}
+	int bits = 0;
+	while ((1 << bits) < size) {
+		bits++;
+	}
+	for (int i = 0; i < size; i++) {
+		int reversed = 0;
+		for (int bit = 0; bit < bits; bit++) {
+			reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+		}
+		m_reversed[i] = reversed;
+	}
+}
+
+void Fft::transform(std::complex<double> * data, bool inverse) const {
+	for (int i = 0; i < m_size; i++) {
+		if (i < m_reversed[i]) {
+			std::swap(data[i], data[m_reversed[i]]);
+		}
+	}
+	//Iterative radix 2, combining pairs of transforms of half the length each pass. The complex
+	//math is written out, so the compiler doesn't have to handle infinities and NaNs like std::complex does.
+	double * values = reinterpret_cast<double *>(data);
+	const double * twiddles = reinterpret_cast<const double *>(m_twiddles.data());
+	double sign = (inverse) ? -1.0 : 1.0; //The inverse uses the conjugates of the twiddle factors.
+	for (int length = 2; length <= m_size; length *= 2) {
+		int half = length / 2, stride = m_size / length;
+		for (int start = 0; start < m_size; start += length) {
+			double * even = values + start * 2, * odd = values + (start + half) * 2;
+			for (int k = 0; k < half; k++) {
+				double twiddleReal = twiddles[k * stride * 2], twiddleImag = twiddles[k * stride * 2 + 1] * sign;
+				double oddReal = odd[k * 2] * twiddleReal - odd[k * 2 + 1] * twiddleImag;
+				double oddImag = odd[k * 2] * twiddleImag + odd[k * 2 + 1] * twiddleReal;
+				double evenReal = even[k * 2], evenImag = even[k * 2 + 1];
+				even[k * 2] = evenReal + oddReal;
+				even[k * 2 + 1] = evenImag + oddImag;
+				odd[k * 2] = evenReal - oddReal;
+				odd[k * 2 + 1] = evenImag - oddImag;
+			}
+		}
+	}
+}
+
+void Fft::forward(std::complex<double> * data) const {
+	transform(data, false);
+}
+
+void Fft::inverse(std::complex<double> * data) const {
+	transform(data, true);
+}
+
+} /* namespace Adsp */
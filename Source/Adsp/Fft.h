@@ -0,0 +1,67 @@
+/*
+ * Fft.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_FFT_H_
+#define SOURCE_ADSP_FFT_H_
+
+#include <complex>
+#include <vector>
+
+namespace Adsp {
+/**
+ * @defgroup fft
+ * @ingroup Adsp
+ * A fast fourier transform, for turning blocks of samples
+ * into spectra and back.
+ * @{
+ */
+
+/**
+ * Computes fast fourier transforms of a single size. The
+ * twiddle factors and bit reversal order are computed once,
+ * when the object is created, so transforms do not allocate
+ * or call any trig functions.
+ */
+class Fft {
+private:
+	int m_size;
+	std::vector<std::complex<double>> m_twiddles; ///< e^(-2 pi i k / size), for k between 0 and size / 2.
+	std::vector<int> m_reversed; ///< Where each index goes to in bit reversed order.
+	void transform(std::complex<double> * data, bool inverse) const;
+public:
+	/**
+	 * Prepares to do transforms of the given size.
+	 * @param size How many points each transform has. Must be a power of 2.
+	 */
+	Fft(int size);
+
+	/**
+	 * Gets the size of the transforms.
+	 * @return How many points each transform has.
+	 */
+	int getSize() const {
+		return m_size;
+	}
+	/**
+	 * Transforms a block of samples into a spectrum, in place.
+	 * @param data getSize() samples, which are replaced by their spectrum.
+	 */
+	void forward(std::complex<double> * data) const;
+	/**
+	 * Transforms a spectrum into a block of samples, in place.
+	 * The result is not divided by getSize(), so doing
+	 * forward() and then inverse() multiplies everything by
+	 * getSize().
+	 * @param data A spectrum of getSize() bins, which is replaced by the samples.
+	 */
+	void inverse(std::complex<double> * data) const;
+};
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_FFT_H_ */
@@ -11,20 +11,33 @@
 
 namespace Adsp {
 
-void createHammingWindow(int size, double* destination) {
-	double offset = (2 * M_PI) / (size - 1);
-	for(double x = 0; x < M_PI * 2; x += offset) {
-		*destination = 0.54 - 0.46 * std::cos(x);
-		destination++;
+/**
+ * Renders a window made of cosines, a0 - a1 * cos(x) + a2 *
+ * cos(2x), where x goes from 0 to 2 pi. cos(x) comes from
+ * rotating a point around a circle by the same angle for
+ * every sample instead of calling cos() for each one. The
+ * window is symmetric, so each point is used for a sample
+ * in both halves.
+ */
+static void createCosineWindow(int size, double* destination, double a0, double a1, double a2) {
+	double step = (2 * M_PI) / (size - 1), stepCos = std::cos(step), stepSin = std::sin(step);
+	double c = 1.0, s = 0.0; //cos(x) and sin(x), starting at x = 0.
+	for(int i = 0; i <= (size - 1) / 2; i++) {
+		double value = a0 - a1 * c + a2 * (2 * c * c - 1); //cos(2x) = 2cos(x)^2 - 1
+		destination[i] = value;
+		destination[size - 1 - i] = value;
+		double next = c * stepCos - s * stepSin;
+		s = s * stepCos + c * stepSin;
+		c = next;
 	}
 }
 
+void createHammingWindow(int size, double* destination) {
+	createCosineWindow(size, destination, 0.54, 0.46, 0.0);
+}
+
 void createBlackmanWindow(int size, double* destination) {
-	double offset = (2 * M_PI) / (size - 1);
-	for(double x = 0; x < M_PI * 2; x += offset) {
-		*destination = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2 * x);
-		destination++;
-	}
+	createCosineWindow(size, destination, 0.42, 0.5, 0.08);
 }
 
 /**
@@ -36,22 +49,28 @@ void createBlackmanWindow(int size, double* destination) {
  * @param window A pointer to the first element of an array containing the window to use.
  */
 void windowedSinc(int size, double* destination, double freqFrac, double* window) {
-	double sinMult = 2 * M_PI * freqFrac, sum = 0.0;
+	double sinMult = 2 * M_PI * freqFrac, stepCos = std::cos(sinMult), stepSin = std::sin(sinMult);
 	int offset = size / 2;
-	double *iter = destination;
-	//E.G. if size is 256, loops from -128 to 127. +0.01 is to avoid div0 errors.
-	for(double x = -offset + 0.01; x < size - offset + 0.01; x++) {
-		*iter = (sin(sinMult * x) / x) * *window;
-		sum += *iter;
-		iter++;
-		window++;
-	}
-	iter = destination;
-	sum = 1.0 / sum; //One division and many multiplications is better than many divisions.
-	for(int i = 0; i < size; i++) {
-		(*iter) *= sum;
-		iter++;
+	//sin(x) / x at x = 0 is the limit, sinMult.
+	destination[offset] = sinMult * window[offset];
+	double sum = destination[offset];
+	//sin(sinMult * x) / x is the same either side of the center, so each value of it is used twice. sin(sinMult
+	//* x) comes from rotating a point by sinMult for each sample, which is much faster than calling sin().
+	double c = stepCos, s = stepSin;
+	for(int x = 1; x <= offset; x++) {
+		double sinc = s / x;
+		destination[offset - x] = sinc * window[offset - x];
+		sum += destination[offset - x];
+		if(offset + x < size) {
+			destination[offset + x] = sinc * window[offset + x];
+			sum += destination[offset + x];
+		}
+		double next = c * stepCos - s * stepSin;
+		s = s * stepCos + c * stepSin;
+		c = next;
 	}
+	//One division and many multiplications is better than many divisions.
+	scaleBlock(destination, 1.0 / sum, destination, size);
 }
 
 /**
@@ -83,8 +102,7 @@ void createDebugCoefficients(int size, double* destination, double* window) {
 	int offset = size / 2;
 	double sum = 0.0;
 	double *iter = destination;
-	//E.G. if size is 256, loops from -128 to 127. +0.01 is to avoid div0 errors.
-	for(double x = -offset + 0.01; x < size - offset + 0.01; x++) {
+	for(int i = 0; i < size; i++) {
 		*iter = *window;
 		sum += *iter;
 		iter++;
@@ -12,6 +12,7 @@
 #include <cassert>
 #include <iostream>
 #include "Technical/AudioBuffer.h"
+#include "Vector.h"
 
 namespace Adsp {
 
@@ -43,33 +44,22 @@ public:
 
 	/**
 	 * Filters the signal in input and writes the
-	 * result to output. Output's size should be at
-	 * least input's size plus the size of the filter,
-	 * since the filter will only calculate the last
-	 * [output.getSize()] samples of the input, but
-	 * needs extra samples because of how FIR filters
+	 * result to output. Input's size should be at
+	 * least output's size plus the size of the filter
+	 * minus one, since the filter will only calculate
+	 * the last [output.getSize()] samples of the input,
+	 * but needs extra samples because of how FIR filters
 	 * work.
 	 * @param input The signal to filter.
 	 * @param output Where to write the resulting signal to.
 	 */
 	void compute(AtomSynth::AudioBuffer& input, AtomSynth::AudioBuffer& output)  {
-		double value;
-		int ins, offset = input.getSize() - output.getSize();
-		assert(offset >= N);
+		//The newest sample used for output sample s is input sample offset + s.
+		int offset = input.getSize() - output.getSize();
+		assert(offset >= N - 1);
 		for(int c = 0; c < input.getChannels(); c++) {
-			std::vector<double>::iterator inputIter = input.getData().begin() + c * input.getSize(),
-					outputIter = output.getData().begin() + c * output.getSize();
-			inputIter += offset - N - 1;
-			for(int s = 0; s < output.getSize(); s++) {
-				value = 0.0;
-				ins = s + offset - N - 1;
-				for(int i = 0; i < N; i++) {
-					value += *(inputIter + i) * m_coefficients[i];
-				}
-				*outputIter = value;
-				inputIter++;
-				outputIter++;
-			}
+			const double * inputData = input.getReadData() + c * input.getSize() + offset - (N - 1);
+			firBlock(inputData, m_coefficients.data(), N, output.getData() + c * output.getSize(), output.getSize());
 		}
 	}
 
@@ -85,13 +75,7 @@ public:
 	 * @return A filtered sample, computed by filtering the selected section of signal.
 	 */
 	double compute(AtomSynth::AudioBuffer& input, int channel, int startSample) {
-		double tr = 0.0;
-		std::vector<double>::iterator inputIter = input.getData().begin() + channel * input.getSize() + startSample;
-		for(int i = 0; i < N; i++) {
-			tr += *inputIter * m_coefficients[i];
-			inputIter++;
-		}
-		return tr;
+		return dotProductBlock(input.getReadData() + channel * input.getSize() + startSample, m_coefficients.data(), N);
 	}
 
 	/**
@@ -7,11 +7,13 @@
 
 #include "Interpolation.h"
 
+#include <algorithm>
+
 namespace Adsp {
 
 #ifdef USE_STRICT_CONSTEXPR
 double smoothInterp(double val1, double val2, double blend) {
-	return linearInterp(val1, val2, (6 * pow(blend, 5)) - (15 * pow(blend, 4)) + (10 * pow(blend, 3)));
+	return linearInterp(val1, val2, blend * blend * blend * (blend * (blend * 6.0 - 15.0) + 10.0)); //6x^5 - 15x^4 + 10x^3, without calling pow().
 }
 #endif
 
@@ -20,7 +22,7 @@ double fastEnvelopeInterp(double blend, double shape) {
 		return blend;
 	} else {
 		double blendp = blend * 100.0;
-		int index = int(blendp);
+		int index = std::min(int(blendp), 99); //A blend of exactly 1 would otherwise read past the end of the table.
 		double lookupBlend = blendp - double(index); //This value goes between 0 and 1.
 		if (shape > 0.0) {
 			return linearInterp(blend, linearInterp(ENVELOPE_POSITIVE_SHAPE[index], ENVELOPE_POSITIVE_SHAPE[index + 1], lookupBlend), //Do linear interpolation on the sample data so that the envelope does not have sharp edges.
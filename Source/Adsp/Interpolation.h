@@ -44,7 +44,7 @@ double smoothInterp(double val1, double val2, double blend);
  * @return The blended value.
  */
 constexpr double smoothInterp(double val1, double val2, double blend) {
-	return linearInterp(val1, val2, (6 * pow(blend, 5)) - (15 * pow(blend, 4)) + (10 * pow(blend, 3)));
+	return linearInterp(val1, val2, blend * blend * blend * (blend * (blend * 6.0 - 15.0) + 10.0));
 }
 #endif
 
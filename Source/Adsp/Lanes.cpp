@@ -0,0 +1,442 @@
+/*
+ * Lanes.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Lanes.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Cpu.h"
+#include "FastMath.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ADSP_LANES_X86
+#include <immintrin.h>
+#endif
+
+namespace Adsp {
+
+/**
+ * How many samples are rendered before they are copied
+ * to the outputs. The tile is small enough to stay in L1.
+ */
+constexpr int TILE_SIZE = 32;
+
+//The sine polynomial is the one fastSinPi() uses. SINE_1 is the coefficient of x, SINE_3 of x^3, and so on.
+constexpr double SINE_1 = SIN_PI_PRECISE[0],
+		SINE_3 = SIN_PI_PRECISE[1],
+		SINE_5 = SIN_PI_PRECISE[2],
+		SINE_7 = SIN_PI_PRECISE[3],
+		SINE_9 = SIN_PI_PRECISE[4],
+		SINE_11 = SIN_PI_PRECISE[5],
+		SINE_13 = SIN_PI_PRECISE[6],
+		SINE_15 = SIN_PI_PRECISE[7];
+
+OscillatorLanes::OscillatorLanes() {
+	std::fill(m_phase, m_phase + MAX_LANES, 0.0);
+	std::fill(m_increment, m_increment + MAX_LANES, 0.0);
+	std::fill(m_offset, m_offset + MAX_LANES, 0.0);
+	std::fill(m_center, m_center + MAX_LANES, 0.0);
+	std::fill(m_scale, m_scale + MAX_LANES, 0.0);
+	std::fill(m_bias, m_bias + MAX_LANES, 0.0);
+}
+
+/**
+ * Settings of each lane that the tile renderers need, worked
+ * out once per render so that they don't have to divide.
+ */
+struct LaneConstants {
+	double m_center[MAX_LANES]; ///< The center of each lane. Triangles keep it a sample away from the ends, like triWaveBlamp() does.
+	double m_lowScale[MAX_LANES]; ///< What to multiply the phase by below the center.
+	double m_highScale[MAX_LANES]; ///< What to multiply the phase by above the center.
+	double m_inverseIncrement[MAX_LANES]; ///< 1 / m_increment, for measuring distances in samples.
+	double m_rampScale[MAX_LANES]; ///< How much a triangle's slope changes at its corners, divided by 6.
+};
+
+/**
+ * Same as std::fmod(value, 2.0), as long as value / 2
+ * fits in an int. Truncating rounds towards zero, just
+ * like fmod does, and the result is exact.
+ */
+static double wrapScalar(double value) {
+	return value - 2.0 * double(int(value * 0.5));
+}
+
+//sin(pi * x) is symmetric around 0.5 and -0.5, so only -0.5 to 0.5 needs the polynomial.
+//max(min(x, 1 - x), -1 - x) folds the rest of -1 to 1 into that range.
+static double sineScalar(double phase) {
+	double x = std::max(std::min(phase, 1.0 - phase), -1.0 - phase);
+	double x2 = x * x;
+	return x * (SINE_1 + x2 * (SINE_3 + x2 * (SINE_5 + x2 * (SINE_7 + x2 * (SINE_9 + x2 * (SINE_11 + x2 * (SINE_13 + x2 * SINE_15)))))));
+}
+
+/*
+ * Square and triangle waves are smoothed the same way as
+ * squareWaveBlep() and triWaveBlamp(), but without any
+ * branches. For each corner, t is how many samples past
+ * it the phase is, and closeness is max(1 - |t|, 0). The
+ * polyBLEP is closeness^2, negated after the corner, and
+ * the polyBLAMP is closeness^3 / 6.
+ */
+
+//How many samples past a corner the phase is. The +11.0 keeps the wrapped value positive, so it ends up between -1 and 1.
+static double samplesSinceCornerScalar(double phase, double corner, double inverseIncrement) {
+	return (wrapScalar(phase - corner + 11.0) - 1.0) * inverseIncrement;
+}
+
+static double correctionScalar(int waveform, double phase, double center, double inverseIncrement, double rampScale) {
+	double atCenter = samplesSinceCornerScalar(phase, center, inverseIncrement), atEnd = samplesSinceCornerScalar(phase, 1.0, inverseIncrement);
+	double nearCenter = std::max(1.0 - std::fabs(atCenter), 0.0), nearEnd = std::max(1.0 - std::fabs(atEnd), 0.0);
+	if (waveform == LaneWaveform::SQUARE) {
+		double blepCenter = nearCenter * nearCenter, blepEnd = nearEnd * nearEnd;
+		return ((atCenter < 0.0) ? blepCenter : -blepCenter) - ((atEnd < 0.0) ? blepEnd : -blepEnd);
+	}
+	return (nearEnd * nearEnd * nearEnd - nearCenter * nearCenter * nearCenter) * rampScale;
+}
+
+/**
+ * Renders samples samples of every lane into tile,
+ * which is indexed as tile[sample * MAX_LANES + lane].
+ */
+static void renderTileScalar(OscillatorLanes & lanes, int waveform, const LaneConstants & constants, double * tile, int samples) {
+	for (int s = 0; s < samples; s++) {
+		for (int i = 0; i < MAX_LANES; i++) {
+			lanes.m_phase[i] = wrapScalar(lanes.m_phase[i] + lanes.m_increment[i] + 10.0);
+			double phase = wrapScalar(lanes.m_phase[i] + lanes.m_offset[i]) - 1.0, warped, value;
+			double center = constants.m_center[i];
+			if (phase <= center) {
+				warped = (phase + 1.0) * constants.m_lowScale[i] - 1.0;
+			} else {
+				warped = (phase - center) * constants.m_highScale[i];
+			}
+			switch (waveform) {
+			case LaneWaveform::SINE:
+				value = sineScalar(warped);
+				break;
+			case LaneWaveform::SQUARE:
+				value = (warped > 0.0) ? 1.0 : -1.0;
+				break;
+			default:
+				value = warped * ((warped > 0.0) ? -2.0 : 2.0) + 1.0;
+			}
+			if (waveform != LaneWaveform::SINE) {
+				value += correctionScalar(waveform, phase, center, constants.m_inverseIncrement[i], constants.m_rampScale[i]);
+			}
+			tile[s * MAX_LANES + i] = value * lanes.m_scale[i] + lanes.m_bias[i];
+		}
+	}
+}
+
+#ifdef ADSP_LANES_X86
+/* SSE2 (2 lanes at a time, so each sample takes 4 steps.) */
+
+static __m128d wrapSse2(__m128d value) {
+	//SSE2 can't round doubles, but it can truncate them to ints.
+	__m128d truncated = _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_mul_pd(value, _mm_set1_pd(0.5))));
+	return _mm_sub_pd(value, _mm_add_pd(truncated, truncated));
+}
+
+static __m128d selectSse2(__m128d mask, __m128d ifTrue, __m128d ifFalse) {
+	return _mm_or_pd(_mm_and_pd(mask, ifTrue), _mm_andnot_pd(mask, ifFalse));
+}
+
+static __m128d waveSse2(int waveform, __m128d phase) {
+	__m128d one = _mm_set1_pd(1.0);
+	__m128d positive = _mm_cmpgt_pd(phase, _mm_setzero_pd());
+	switch (waveform) {
+	case LaneWaveform::SINE: {
+		__m128d x = _mm_max_pd(_mm_min_pd(phase, _mm_sub_pd(one, phase)), _mm_sub_pd(_mm_set1_pd(-1.0), phase));
+		__m128d x2 = _mm_mul_pd(x, x), y = _mm_set1_pd(SINE_15);
+		y = _mm_add_pd(_mm_mul_pd(y, x2), _mm_set1_pd(SINE_13));
+		y = _mm_add_pd(_mm_mul_pd(y, x2), _mm_set1_pd(SINE_11));
+		y = _mm_add_pd(_mm_mul_pd(y, x2), _mm_set1_pd(SINE_9));
+		y = _mm_add_pd(_mm_mul_pd(y, x2), _mm_set1_pd(SINE_7));
+		y = _mm_add_pd(_mm_mul_pd(y, x2), _mm_set1_pd(SINE_5));
+		y = _mm_add_pd(_mm_mul_pd(y, x2), _mm_set1_pd(SINE_3));
+		y = _mm_add_pd(_mm_mul_pd(y, x2), _mm_set1_pd(SINE_1));
+		return _mm_mul_pd(y, x);
+	}
+	case LaneWaveform::SQUARE:
+		return selectSse2(positive, one, _mm_set1_pd(-1.0));
+	default:
+		return _mm_add_pd(_mm_mul_pd(phase, selectSse2(positive, _mm_set1_pd(-2.0), _mm_set1_pd(2.0))), one);
+	}
+}
+
+static __m128d samplesSinceCornerSse2(__m128d phase, __m128d corner, __m128d inverseIncrement) {
+	return _mm_mul_pd(_mm_sub_pd(wrapSse2(_mm_add_pd(_mm_sub_pd(phase, corner), _mm_set1_pd(11.0))), _mm_set1_pd(1.0)), inverseIncrement);
+}
+
+static __m128d closenessSse2(__m128d t) {
+	__m128d magnitude = _mm_andnot_pd(_mm_set1_pd(-0.0), t);
+	return _mm_max_pd(_mm_sub_pd(_mm_set1_pd(1.0), magnitude), _mm_setzero_pd());
+}
+
+static __m128d correctionSse2(int waveform, __m128d phase, __m128d center, __m128d inverseIncrement, __m128d rampScale) {
+	__m128d zero = _mm_setzero_pd();
+	__m128d atCenter = samplesSinceCornerSse2(phase, center, inverseIncrement), atEnd = samplesSinceCornerSse2(phase, _mm_set1_pd(1.0), inverseIncrement);
+	__m128d nearCenter = closenessSse2(atCenter), nearEnd = closenessSse2(atEnd);
+	if (waveform == LaneWaveform::SQUARE) {
+		__m128d blepCenter = _mm_mul_pd(nearCenter, nearCenter), blepEnd = _mm_mul_pd(nearEnd, nearEnd);
+		blepCenter = selectSse2(_mm_cmplt_pd(atCenter, zero), blepCenter, _mm_sub_pd(zero, blepCenter));
+		blepEnd = selectSse2(_mm_cmplt_pd(atEnd, zero), blepEnd, _mm_sub_pd(zero, blepEnd));
+		return _mm_sub_pd(blepCenter, blepEnd);
+	}
+	__m128d blampCenter = _mm_mul_pd(_mm_mul_pd(nearCenter, nearCenter), nearCenter);
+	__m128d blampEnd = _mm_mul_pd(_mm_mul_pd(nearEnd, nearEnd), nearEnd);
+	return _mm_mul_pd(_mm_sub_pd(blampEnd, blampCenter), rampScale);
+}
+
+static void renderTileSse2(OscillatorLanes & lanes, int waveform, const LaneConstants & constants, double * tile, int samples) {
+	__m128d one = _mm_set1_pd(1.0), ten = _mm_set1_pd(10.0);
+	for (int s = 0; s < samples; s++) {
+		for (int i = 0; i < MAX_LANES; i += 2) {
+			__m128d phase = wrapSse2(_mm_add_pd(_mm_add_pd(_mm_loadu_pd(lanes.m_phase + i), _mm_loadu_pd(lanes.m_increment + i)), ten));
+			_mm_storeu_pd(lanes.m_phase + i, phase);
+			phase = _mm_sub_pd(wrapSse2(_mm_add_pd(phase, _mm_loadu_pd(lanes.m_offset + i))), one);
+			__m128d center = _mm_loadu_pd(constants.m_center + i);
+			__m128d below = _mm_sub_pd(_mm_mul_pd(_mm_add_pd(phase, one), _mm_loadu_pd(constants.m_lowScale + i)), one);
+			__m128d above = _mm_mul_pd(_mm_sub_pd(phase, center), _mm_loadu_pd(constants.m_highScale + i));
+			__m128d value = waveSse2(waveform, selectSse2(_mm_cmple_pd(phase, center), below, above));
+			if (waveform != LaneWaveform::SINE) {
+				value = _mm_add_pd(value, correctionSse2(waveform, phase, center, _mm_loadu_pd(constants.m_inverseIncrement + i), _mm_loadu_pd(constants.m_rampScale + i)));
+			}
+			value = _mm_add_pd(_mm_mul_pd(value, _mm_loadu_pd(lanes.m_scale + i)), _mm_loadu_pd(lanes.m_bias + i));
+			_mm_storeu_pd(tile + s * MAX_LANES + i, value);
+		}
+	}
+}
+
+/* AVX (4 lanes at a time.) */
+
+ADSP_TARGET_AVX static __m256d multiplyAddAvx(__m256d a, __m256d b, __m256d c) {
+	return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+}
+
+ADSP_TARGET_AVX static __m256d wrapAvx(__m256d value) {
+	__m256d truncated = _mm256_round_pd(_mm256_mul_pd(value, _mm256_set1_pd(0.5)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+	return _mm256_sub_pd(value, _mm256_add_pd(truncated, truncated));
+}
+
+ADSP_TARGET_AVX static __m256d waveAvx(int waveform, __m256d phase) {
+	__m256d one = _mm256_set1_pd(1.0);
+	__m256d positive = _mm256_cmp_pd(phase, _mm256_setzero_pd(), _CMP_GT_OQ);
+	switch (waveform) {
+	case LaneWaveform::SINE: {
+		__m256d x = _mm256_max_pd(_mm256_min_pd(phase, _mm256_sub_pd(one, phase)), _mm256_sub_pd(_mm256_set1_pd(-1.0), phase));
+		__m256d x2 = _mm256_mul_pd(x, x), y = _mm256_set1_pd(SINE_15);
+		y = multiplyAddAvx(y, x2, _mm256_set1_pd(SINE_13));
+		y = multiplyAddAvx(y, x2, _mm256_set1_pd(SINE_11));
+		y = multiplyAddAvx(y, x2, _mm256_set1_pd(SINE_9));
+		y = multiplyAddAvx(y, x2, _mm256_set1_pd(SINE_7));
+		y = multiplyAddAvx(y, x2, _mm256_set1_pd(SINE_5));
+		y = multiplyAddAvx(y, x2, _mm256_set1_pd(SINE_3));
+		y = multiplyAddAvx(y, x2, _mm256_set1_pd(SINE_1));
+		return _mm256_mul_pd(y, x);
+	}
+	case LaneWaveform::SQUARE:
+		return _mm256_blendv_pd(_mm256_set1_pd(-1.0), one, positive);
+	default:
+		return multiplyAddAvx(phase, _mm256_blendv_pd(_mm256_set1_pd(2.0), _mm256_set1_pd(-2.0), positive), one);
+	}
+}
+
+ADSP_TARGET_AVX static __m256d samplesSinceCornerAvx(__m256d phase, __m256d corner, __m256d inverseIncrement) {
+	return _mm256_mul_pd(_mm256_sub_pd(wrapAvx(_mm256_add_pd(_mm256_sub_pd(phase, corner), _mm256_set1_pd(11.0))), _mm256_set1_pd(1.0)), inverseIncrement);
+}
+
+ADSP_TARGET_AVX static __m256d closenessAvx(__m256d t) {
+	__m256d magnitude = _mm256_andnot_pd(_mm256_set1_pd(-0.0), t);
+	return _mm256_max_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), magnitude), _mm256_setzero_pd());
+}
+
+ADSP_TARGET_AVX static __m256d correctionAvx(int waveform, __m256d phase, __m256d center, __m256d inverseIncrement, __m256d rampScale) {
+	__m256d zero = _mm256_setzero_pd();
+	__m256d atCenter = samplesSinceCornerAvx(phase, center, inverseIncrement), atEnd = samplesSinceCornerAvx(phase, _mm256_set1_pd(1.0), inverseIncrement);
+	__m256d nearCenter = closenessAvx(atCenter), nearEnd = closenessAvx(atEnd);
+	if (waveform == LaneWaveform::SQUARE) {
+		__m256d blepCenter = _mm256_mul_pd(nearCenter, nearCenter), blepEnd = _mm256_mul_pd(nearEnd, nearEnd);
+		blepCenter = _mm256_blendv_pd(_mm256_sub_pd(zero, blepCenter), blepCenter, _mm256_cmp_pd(atCenter, zero, _CMP_LT_OQ));
+		blepEnd = _mm256_blendv_pd(_mm256_sub_pd(zero, blepEnd), blepEnd, _mm256_cmp_pd(atEnd, zero, _CMP_LT_OQ));
+		return _mm256_sub_pd(blepCenter, blepEnd);
+	}
+	__m256d blampCenter = _mm256_mul_pd(_mm256_mul_pd(nearCenter, nearCenter), nearCenter);
+	__m256d blampEnd = _mm256_mul_pd(_mm256_mul_pd(nearEnd, nearEnd), nearEnd);
+	return _mm256_mul_pd(_mm256_sub_pd(blampEnd, blampCenter), rampScale);
+}
+
+ADSP_TARGET_AVX static void renderTileAvx(OscillatorLanes & lanes, int waveform, const LaneConstants & constants, double * tile, int samples) {
+	__m256d one = _mm256_set1_pd(1.0), ten = _mm256_set1_pd(10.0);
+	for (int s = 0; s < samples; s++) {
+		for (int i = 0; i < MAX_LANES; i += 4) {
+			__m256d phase = wrapAvx(_mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(lanes.m_phase + i), _mm256_loadu_pd(lanes.m_increment + i)), ten));
+			_mm256_storeu_pd(lanes.m_phase + i, phase);
+			phase = _mm256_sub_pd(wrapAvx(_mm256_add_pd(phase, _mm256_loadu_pd(lanes.m_offset + i))), one);
+			__m256d center = _mm256_loadu_pd(constants.m_center + i);
+			__m256d below = _mm256_sub_pd(_mm256_mul_pd(_mm256_add_pd(phase, one), _mm256_loadu_pd(constants.m_lowScale + i)), one);
+			__m256d above = _mm256_mul_pd(_mm256_sub_pd(phase, center), _mm256_loadu_pd(constants.m_highScale + i));
+			__m256d value = waveAvx(waveform, _mm256_blendv_pd(above, below, _mm256_cmp_pd(phase, center, _CMP_LE_OQ)));
+			if (waveform != LaneWaveform::SINE) {
+				value = _mm256_add_pd(value, correctionAvx(waveform, phase, center, _mm256_loadu_pd(constants.m_inverseIncrement + i), _mm256_loadu_pd(constants.m_rampScale + i)));
+			}
+			value = multiplyAddAvx(value, _mm256_loadu_pd(lanes.m_scale + i), _mm256_loadu_pd(lanes.m_bias + i));
+			_mm256_storeu_pd(tile + s * MAX_LANES + i, value);
+		}
+	}
+}
+
+/* AVX-512 (All 8 lanes at once. GCC 12 warns that the unmasked min, max
+ * and roundscale intrinsics read an uninitialized vector, so the zero-masked
+ * forms are used with every lane enabled.) */
+
+#define ALL_LANES __mmask8(0xFF)
+
+ADSP_TARGET_AVX512 static __m512d wrapAvx512(__m512d value) {
+	__m512d truncated = _mm512_maskz_roundscale_pd(ALL_LANES, _mm512_mul_pd(value, _mm512_set1_pd(0.5)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+	return _mm512_sub_pd(value, _mm512_add_pd(truncated, truncated));
+}
+
+ADSP_TARGET_AVX512 static __m512d waveAvx512(int waveform, __m512d phase) {
+	__m512d one = _mm512_set1_pd(1.0);
+	__mmask8 positive = _mm512_cmp_pd_mask(phase, _mm512_setzero_pd(), _CMP_GT_OQ);
+	switch (waveform) {
+	case LaneWaveform::SINE: {
+		__m512d x = _mm512_maskz_max_pd(ALL_LANES, _mm512_maskz_min_pd(ALL_LANES, phase, _mm512_sub_pd(one, phase)), _mm512_sub_pd(_mm512_set1_pd(-1.0), phase));
+		__m512d x2 = _mm512_mul_pd(x, x), y = _mm512_set1_pd(SINE_15);
+		y = _mm512_fmadd_pd(y, x2, _mm512_set1_pd(SINE_13));
+		y = _mm512_fmadd_pd(y, x2, _mm512_set1_pd(SINE_11));
+		y = _mm512_fmadd_pd(y, x2, _mm512_set1_pd(SINE_9));
+		y = _mm512_fmadd_pd(y, x2, _mm512_set1_pd(SINE_7));
+		y = _mm512_fmadd_pd(y, x2, _mm512_set1_pd(SINE_5));
+		y = _mm512_fmadd_pd(y, x2, _mm512_set1_pd(SINE_3));
+		y = _mm512_fmadd_pd(y, x2, _mm512_set1_pd(SINE_1));
+		return _mm512_mul_pd(y, x);
+	}
+	case LaneWaveform::SQUARE:
+		return _mm512_mask_blend_pd(positive, _mm512_set1_pd(-1.0), one);
+	default:
+		return _mm512_fmadd_pd(phase, _mm512_mask_blend_pd(positive, _mm512_set1_pd(2.0), _mm512_set1_pd(-2.0)), one);
+	}
+}
+
+ADSP_TARGET_AVX512 static __m512d samplesSinceCornerAvx512(__m512d phase, __m512d corner, __m512d inverseIncrement) {
+	return _mm512_mul_pd(_mm512_sub_pd(wrapAvx512(_mm512_add_pd(_mm512_sub_pd(phase, corner), _mm512_set1_pd(11.0))), _mm512_set1_pd(1.0)), inverseIncrement);
+}
+
+ADSP_TARGET_AVX512 static __m512d closenessAvx512(__m512d t) {
+	return _mm512_maskz_max_pd(ALL_LANES, _mm512_sub_pd(_mm512_set1_pd(1.0), _mm512_abs_pd(t)), _mm512_setzero_pd());
+}
+
+ADSP_TARGET_AVX512 static __m512d correctionAvx512(int waveform, __m512d phase, __m512d center, __m512d inverseIncrement, __m512d rampScale) {
+	__m512d zero = _mm512_setzero_pd();
+	__m512d atCenter = samplesSinceCornerAvx512(phase, center, inverseIncrement), atEnd = samplesSinceCornerAvx512(phase, _mm512_set1_pd(1.0), inverseIncrement);
+	__m512d nearCenter = closenessAvx512(atCenter), nearEnd = closenessAvx512(atEnd);
+	if (waveform == LaneWaveform::SQUARE) {
+		__m512d blepCenter = _mm512_mul_pd(nearCenter, nearCenter), blepEnd = _mm512_mul_pd(nearEnd, nearEnd);
+		blepCenter = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(atCenter, zero, _CMP_LT_OQ), _mm512_sub_pd(zero, blepCenter), blepCenter);
+		blepEnd = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(atEnd, zero, _CMP_LT_OQ), _mm512_sub_pd(zero, blepEnd), blepEnd);
+		return _mm512_sub_pd(blepCenter, blepEnd);
+	}
+	__m512d blampCenter = _mm512_mul_pd(_mm512_mul_pd(nearCenter, nearCenter), nearCenter);
+	__m512d blampEnd = _mm512_mul_pd(_mm512_mul_pd(nearEnd, nearEnd), nearEnd);
+	return _mm512_mul_pd(_mm512_sub_pd(blampEnd, blampCenter), rampScale);
+}
+
+ADSP_TARGET_AVX512 static void renderTileAvx512(OscillatorLanes & lanes, int waveform, const LaneConstants & constants, double * tile, int samples) {
+	__m512d one = _mm512_set1_pd(1.0), ten = _mm512_set1_pd(10.0);
+	__m512d increment = _mm512_loadu_pd(lanes.m_increment), offset = _mm512_loadu_pd(lanes.m_offset),
+			center = _mm512_loadu_pd(constants.m_center), lowScale = _mm512_loadu_pd(constants.m_lowScale),
+			highScale = _mm512_loadu_pd(constants.m_highScale), inverseIncrement = _mm512_loadu_pd(constants.m_inverseIncrement),
+			rampScale = _mm512_loadu_pd(constants.m_rampScale), scale = _mm512_loadu_pd(lanes.m_scale), bias = _mm512_loadu_pd(lanes.m_bias);
+	__m512d phases = _mm512_loadu_pd(lanes.m_phase);
+	for (int s = 0; s < samples; s++) {
+		phases = wrapAvx512(_mm512_add_pd(_mm512_add_pd(phases, increment), ten));
+		__m512d phase = _mm512_sub_pd(wrapAvx512(_mm512_add_pd(phases, offset)), one);
+		__m512d below = _mm512_sub_pd(_mm512_mul_pd(_mm512_add_pd(phase, one), lowScale), one);
+		__m512d above = _mm512_mul_pd(_mm512_sub_pd(phase, center), highScale);
+		__m512d value = waveAvx512(waveform, _mm512_mask_blend_pd(_mm512_cmp_pd_mask(phase, center, _CMP_LE_OQ), above, below));
+		if (waveform != LaneWaveform::SINE) {
+			value = _mm512_add_pd(value, correctionAvx512(waveform, phase, center, inverseIncrement, rampScale));
+		}
+		_mm512_storeu_pd(tile + s * MAX_LANES, _mm512_fmadd_pd(value, scale, bias));
+	}
+	_mm512_storeu_pd(lanes.m_phase, phases);
+}
+
+#undef ALL_LANES
+#endif
+
+typedef void (* RenderTileFunction)(OscillatorLanes &, int, const LaneConstants &, double *, int);
+
+/**
+ * Versions of the tile renderer for each SimdLevel, in
+ * the same order as SimdLevel. AVX2 has nothing over AVX
+ * here except FMA, which only saves a few adds.
+ */
+static const RenderTileFunction RENDER_TILE[] = {
+	renderTileScalar,
+#ifdef ADSP_LANES_X86
+	renderTileSse2,
+	renderTileAvx,
+	renderTileAvx,
+	renderTileAvx512,
+#endif
+};
+
+static void computeLaneConstants(const OscillatorLanes & lanes, int waveform, LaneConstants & constants) {
+	for (int i = 0; i < MAX_LANES; i++) {
+		double increment = std::max(std::min(std::fabs(lanes.m_increment[i]), 1.0), 1.0e-9), center = lanes.m_center[i];
+		if (waveform == LaneWaveform::TRIANGLE) {
+			center = std::max(-1.0 + increment, std::min(1.0 - increment, center));
+		}
+		constants.m_center[i] = center;
+		//1.0e-64 is there to prevent divide by zero errors when the center is -1.0, same as in BasicOsc.
+		constants.m_lowScale[i] = 1.0 / (center + 1.0 + 1.0e-64);
+		//Nothing is ever above a center of 1.0, so any finite value works there.
+		constants.m_highScale[i] = (center < 1.0) ? 1.0 / (1.0 - center) : 0.0;
+		constants.m_inverseIncrement[i] = 1.0 / increment;
+		constants.m_rampScale[i] = (waveform == LaneWaveform::TRIANGLE) ? 4.0 * increment / (1.0 - center * center) / 6.0 : 0.0;
+	}
+}
+
+void renderOscillatorLanes(OscillatorLanes & lanes, int waveform, double * const * outputs, int count, int samples) {
+	LaneConstants constants;
+	double tile[TILE_SIZE * MAX_LANES];
+	computeLaneConstants(lanes, waveform, constants);
+
+	RenderTileFunction render = RENDER_TILE[int(getSimdLevel())];
+	for (int start = 0; start < samples; start += TILE_SIZE) {
+		int size = std::min(TILE_SIZE, samples - start);
+		render(lanes, waveform, constants, tile, size);
+		for (int i = 0; i < count; i++) {
+			double * output = outputs[i] + start;
+			for (int s = 0; s < size; s++) {
+				output[s] = tile[s * MAX_LANES + i];
+			}
+		}
+	}
+}
+
+void mixOscillatorLanes(OscillatorLanes & lanes, int waveform, double * output, int count, int samples) {
+	LaneConstants constants;
+	double tile[TILE_SIZE * MAX_LANES];
+	computeLaneConstants(lanes, waveform, constants);
+
+	RenderTileFunction render = RENDER_TILE[int(getSimdLevel())];
+	for (int start = 0; start < samples; start += TILE_SIZE) {
+		int size = std::min(TILE_SIZE, samples - start);
+		render(lanes, waveform, constants, tile, size);
+		for (int s = 0; s < size; s++) {
+			double total = 0.0;
+			for (int i = 0; i < count; i++) {
+				total += tile[s * MAX_LANES + i];
+			}
+			output[start + s] += total;
+		}
+	}
+}
+
+} /* namespace Adsp */
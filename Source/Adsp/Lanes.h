@@ -0,0 +1,94 @@
+/*
+ * Lanes.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_LANES_H_
+#define SOURCE_ADSP_LANES_H_
+
+namespace Adsp {
+/**
+ * @defgroup lanes
+ * @ingroup Adsp
+ * Kernels that process several voices at once. Every voice
+ * runs the same code on different data, so each voice gets
+ * one SIMD lane: the state of all voices is stored in
+ * structure-of-arrays form, and each step of the kernel is
+ * done for every lane before moving on to the next step.
+ * Rendering MAX_LANES voices this way costs about as much as
+ * rendering one voice the normal way. Like @ref vector, the
+ * kernels use the widest instructions getSimdLevel() allows.
+ * @{
+ */
+
+/**
+ * How many voices the kernels process at once. Kernels
+ * always compute every lane, lanes that are not in use
+ * are just not written anywhere.
+ */
+constexpr int MAX_LANES = 8;
+
+/**
+ * Waveforms renderOscillatorLanes() can produce. They are
+ * in the same order as the waveforms in Waveform.h.
+ */
+namespace LaneWaveform {
+	static constexpr int SINE = 0,
+			SQUARE = 1,
+			TRIANGLE = 2;
+}
+
+/**
+ * The state and settings of MAX_LANES oscillators, for one
+ * channel. Element i of each array belongs to lane i.
+ */
+struct OscillatorLanes {
+	double m_phase[MAX_LANES]; ///< Phase of each oscillator, between 0 and 2. This is updated by renderOscillatorLanes().
+	double m_increment[MAX_LANES]; ///< How much phase to add every sample. Must be between -1000 and 1000.
+	double m_offset[MAX_LANES]; ///< How much phase to add to m_phase before computing the wave. Must be at least 0.
+	double m_center[MAX_LANES]; ///< Where phase 0 is moved to, between -1 and 1. See BasicOscController.
+	double m_scale[MAX_LANES]; ///< What to multiply the wave by.
+	double m_bias[MAX_LANES]; ///< What to add to the wave after multiplying it.
+
+	/**
+	 * Sets up every lane to output silence.
+	 */
+	OscillatorLanes();
+};
+
+/**
+ * Renders a block of samples for every lane. For each
+ * sample of each lane, it computes
+ * m_phase = fmod(m_phase + m_increment + 10, 2), then
+ * wave(fmod(m_phase + m_offset, 2) - 1) with phase 0 moved
+ * to m_center, then multiplies by m_scale and adds m_bias.
+ * The sine is the same polynomial as fastSinPi(). Square and triangle waves are smoothed like
+ * squareWaveBlep() and triWaveBlamp(). Increments must be
+ * smaller than 1000 so that phases can be wrapped without
+ * fmod.
+ * @param lanes The oscillators to render.
+ * @param waveform Which wave to compute, from LaneWaveform.
+ * @param outputs Where to write each lane to. outputs[i] receives samples samples from lane i.
+ * @param count How many entries of outputs to write to.
+ * @param samples How many samples to render.
+ */
+void renderOscillatorLanes(OscillatorLanes & lanes, int waveform, double * const * outputs, int count, int samples);
+/**
+ * Like renderOscillatorLanes(), but instead of writing
+ * each lane to its own output, the first count lanes are
+ * added together and added to output. This is how unison
+ * voices are rendered.
+ * @param lanes The oscillators to render.
+ * @param waveform Which wave to compute, from LaneWaveform.
+ * @param output Where to add the lanes to.
+ * @param count How many lanes to add up.
+ * @param samples How many samples to render.
+ */
+void mixOscillatorLanes(OscillatorLanes & lanes, int waveform, double * output, int count, int samples);
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_LANES_H_ */
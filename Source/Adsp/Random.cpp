@@ -0,0 +1,182 @@
+/*
+ * Random.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Random.h"
+
+#include <cstring>
+
+#include "Cpu.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ADSP_RANDOM_X86
+#include <immintrin.h>
+#endif
+
+namespace Adsp {
+
+//Constants from the Philox paper. (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+constexpr std::uint32_t PHILOX_MULTIPLIER = 0xD256D193, PHILOX_KEY_STEP = 0x9E3779B9;
+constexpr int PHILOX_ROUNDS = 10;
+//Putting 52 random bits under this exponent gives a double from 2 to 4.
+constexpr std::uint64_t TWO_TO_FOUR = 0x4000000000000000ull;
+
+/**
+ * Scrambles a counter (c0 is the low half, c1 the high
+ * half) into two random words.
+ */
+static void philoxScalar(std::uint32_t key, std::uint32_t & c0, std::uint32_t & c1) {
+	for (int round = 0; round < PHILOX_ROUNDS; round++) {
+		std::uint64_t product = std::uint64_t(PHILOX_MULTIPLIER) * c0;
+		std::uint32_t high = std::uint32_t(product >> 32), low = std::uint32_t(product);
+		c0 = high ^ key ^ c1;
+		c1 = low;
+		key += PHILOX_KEY_STEP;
+	}
+}
+
+//Turns the two words into a double from -1 to 1, keeping 52 of their bits.
+static double toDouble(std::uint32_t c0, std::uint32_t c1) {
+	std::uint64_t bits = (((std::uint64_t(c0) << 32) | c1) >> 12) | TWO_TO_FOUR;
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value - 3.0;
+}
+
+static void fillScalar(std::uint32_t key, std::uint64_t counter, double * destination, int samples) {
+	for (int i = 0; i < samples; i++) {
+		std::uint32_t c0 = std::uint32_t(counter + i), c1 = std::uint32_t((counter + i) >> 32);
+		philoxScalar(key, c0, c1);
+		destination[i] = toDouble(c0, c1);
+	}
+}
+
+/**
+ * Checks if the low half of the counter stays the same
+ * for a whole block, so that the SIMD versions only have
+ * to add to the high half. It only changes once every 4
+ * billion numbers.
+ */
+static bool highHalfIsConstant(std::uint64_t counter, int samples) {
+	return (counter & 0xFFFFFFFFull) + std::uint64_t(samples) <= 0x100000000ull;
+}
+
+#ifdef ADSP_RANDOM_X86
+/* SSE2 (4 numbers at a time.) */
+
+static void philoxSse2(std::uint32_t key, __m128i & c0, __m128i & c1) {
+	__m128i multiplier = _mm_set1_epi32(int(PHILOX_MULTIPLIER)), lowMask = _mm_set1_epi64x(0xFFFFFFFFll);
+	for (int round = 0; round < PHILOX_ROUNDS; round++) {
+		//SSE2 can only multiply every other 32 bit word, so the even and odd words are done separately.
+		__m128i even = _mm_mul_epu32(c0, multiplier), odd = _mm_mul_epu32(_mm_srli_epi64(c0, 32), multiplier);
+		__m128i low = _mm_or_si128(_mm_and_si128(even, lowMask), _mm_slli_epi64(odd, 32));
+		__m128i high = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(lowMask, odd));
+		c0 = _mm_xor_si128(_mm_xor_si128(high, _mm_set1_epi32(int(key))), c1);
+		c1 = low;
+		key += PHILOX_KEY_STEP;
+	}
+}
+
+static __m128d toDoubleSse2(__m128i bits) {
+	bits = _mm_or_si128(_mm_srli_epi64(bits, 12), _mm_set1_epi64x(TWO_TO_FOUR));
+	return _mm_sub_pd(_mm_castsi128_pd(bits), _mm_set1_pd(3.0));
+}
+
+static void fillSse2(std::uint32_t key, std::uint64_t counter, double * destination, int samples) {
+	int i = 0;
+	if (highHalfIsConstant(counter, samples)) {
+		__m128i offsets = _mm_setr_epi32(0, 1, 2, 3), high = _mm_set1_epi32(int(counter >> 32));
+		for (; i + 4 <= samples; i += 4) {
+			__m128i c0 = _mm_add_epi32(_mm_set1_epi32(int(std::uint32_t(counter) + i)), offsets), c1 = high;
+			philoxSse2(key, c0, c1);
+			//Interleaving puts c0 in the high half of each 64 bit word, like toDouble() does.
+			_mm_storeu_pd(destination + i, toDoubleSse2(_mm_unpacklo_epi32(c1, c0)));
+			_mm_storeu_pd(destination + i + 2, toDoubleSse2(_mm_unpackhi_epi32(c1, c0)));
+		}
+	}
+	fillScalar(key, counter + i, destination + i, samples - i);
+}
+
+/* AVX2 (8 numbers at a time. AVX on its own has no 256 bit integer instructions.) */
+
+ADSP_TARGET_AVX2 static void philoxAvx2(std::uint32_t key, __m256i & c0, __m256i & c1) {
+	__m256i multiplier = _mm256_set1_epi32(int(PHILOX_MULTIPLIER)), lowMask = _mm256_set1_epi64x(0xFFFFFFFFll);
+	for (int round = 0; round < PHILOX_ROUNDS; round++) {
+		__m256i even = _mm256_mul_epu32(c0, multiplier), odd = _mm256_mul_epu32(_mm256_srli_epi64(c0, 32), multiplier);
+		__m256i low = _mm256_or_si256(_mm256_and_si256(even, lowMask), _mm256_slli_epi64(odd, 32));
+		__m256i high = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_andnot_si256(lowMask, odd));
+		c0 = _mm256_xor_si256(_mm256_xor_si256(high, _mm256_set1_epi32(int(key))), c1);
+		c1 = low;
+		key += PHILOX_KEY_STEP;
+	}
+}
+
+ADSP_TARGET_AVX2 static __m256d toDoubleAvx2(__m256i bits) {
+	bits = _mm256_or_si256(_mm256_srli_epi64(bits, 12), _mm256_set1_epi64x(TWO_TO_FOUR));
+	return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(3.0));
+}
+
+ADSP_TARGET_AVX2 static void fillAvx2(std::uint32_t key, std::uint64_t counter, double * destination, int samples) {
+	int i = 0;
+	if (highHalfIsConstant(counter, samples)) {
+		__m256i offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), high = _mm256_set1_epi32(int(counter >> 32));
+		for (; i + 8 <= samples; i += 8) {
+			__m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(int(std::uint32_t(counter) + i)), offsets), c1 = high;
+			philoxAvx2(key, c0, c1);
+			//The unpacks work inside each 128 bit half, giving numbers 0, 1, 4, 5 and 2, 3, 6, 7.
+			__m256i first = _mm256_unpacklo_epi32(c1, c0), second = _mm256_unpackhi_epi32(c1, c0);
+			_mm256_storeu_pd(destination + i, toDoubleAvx2(_mm256_permute2x128_si256(first, second, 0x20)));
+			_mm256_storeu_pd(destination + i + 4, toDoubleAvx2(_mm256_permute2x128_si256(first, second, 0x31)));
+		}
+	}
+	fillScalar(key, counter + i, destination + i, samples - i);
+}
+#endif
+
+typedef void (* FillFunction)(std::uint32_t, std::uint64_t, double *, int);
+
+/**
+ * Versions of fill() for each SimdLevel, in the same order
+ * as SimdLevel. Philox is all integer math, so AVX is no
+ * better than SSE2, and AVX-512 is not worth a version of
+ * its own.
+ */
+static const FillFunction FILL[] = {
+	fillScalar,
+#ifdef ADSP_RANDOM_X86
+	fillSse2,
+	fillSse2,
+	fillAvx2,
+	fillAvx2,
+#endif
+};
+
+//A 32 bit integer hash. (Chris Wellons' "lowbias32".)
+static std::uint32_t hash(std::uint32_t value) {
+	value ^= value >> 16;
+	value *= 0x7FEB352D;
+	value ^= value >> 15;
+	value *= 0x846CA68B;
+	value ^= value >> 16;
+	return value;
+}
+
+std::uint32_t CounterRandom::makeKey(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+	return hash(a ^ hash(b ^ hash(c + PHILOX_KEY_STEP)));
+}
+
+double CounterRandom::next() {
+	std::uint32_t c0 = std::uint32_t(m_counter), c1 = std::uint32_t(m_counter >> 32);
+	philoxScalar(m_key, c0, c1);
+	m_counter++;
+	return toDouble(c0, c1);
+}
+
+void CounterRandom::fill(double * destination, int samples) {
+	FILL[int(getSimdLevel())](m_key, m_counter, destination, samples);
+	m_counter += samples;
+}
+
+} /* namespace Adsp */
@@ -0,0 +1,90 @@
+/*
+ * Random.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_RANDOM_H_
+#define SOURCE_ADSP_RANDOM_H_
+
+#include <cstdint>
+
+namespace Adsp {
+/**
+ * @defgroup random
+ * @ingroup Adsp
+ * Random numbers for audio code. Unlike rand(), every
+ * generator has its own state, so voices don't affect each
+ * other's numbers, and a generator always gives the same
+ * numbers for the same key.
+ * @{
+ */
+
+/**
+ * A counter based random number generator (Philox 2x32-10).
+ * The n-th number is computed from just the key and n, by
+ * scrambling n with the key over 10 rounds. There is no
+ * state to carry from one number to the next besides the
+ * counter, so whole blocks of numbers can be computed in
+ * parallel using SIMD. (See @ref cpu.)
+ */
+class CounterRandom {
+private:
+	std::uint32_t m_key;
+	std::uint64_t m_counter = 0;
+public:
+	/**
+	 * Creates a generator.
+	 * @param key Which stream of numbers to produce. See makeKey().
+	 */
+	CounterRandom(std::uint32_t key = 0) :
+			m_key(key) {
+	}
+
+	/**
+	 * Mixes a few numbers together into a key. Keys made
+	 * from different numbers give unrelated streams, even
+	 * if the numbers only differ by one.
+	 * @param a The first number, such as a voice.
+	 * @param b The second number, such as when a note started.
+	 * @param c The third number, such as a channel.
+	 * @return A key for seed().
+	 */
+	static std::uint32_t makeKey(std::uint32_t a, std::uint32_t b = 0, std::uint32_t c = 0);
+
+	/**
+	 * Starts a new stream of numbers from the beginning.
+	 * @param key Which stream of numbers to produce.
+	 */
+	void seed(std::uint32_t key) {
+		m_key = key;
+		m_counter = 0;
+	}
+	/**
+	 * Gets how many numbers have been generated since the
+	 * last seed().
+	 * @return The index of the next number.
+	 */
+	std::uint64_t getCounter() const {
+		return m_counter;
+	}
+
+	/**
+	 * Generates one number.
+	 * @return A uniformly distributed double, from -1 to (just under) 1.
+	 */
+	double next();
+	/**
+	 * Generates a block of numbers, the same ones that many
+	 * calls to next() would generate, but using SIMD.
+	 * @param destination Where to put the numbers. Each one is from -1 to (just under) 1.
+	 * @param samples How many numbers to generate.
+	 */
+	void fill(double * destination, int samples);
+};
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_RANDOM_H_ */
@@ -0,0 +1,512 @@
+/*
+ * Vector.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Vector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Basic.h"
+#include "Cpu.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ADSP_VECTOR_X86
+#include <immintrin.h>
+#endif
+
+namespace Adsp {
+
+/**
+ * Pointers to one version of each block operation.
+ * There is one of these for every SimdLevel.
+ */
+struct VectorKernels {
+	void (* m_add)(const double *, double *, int);
+	void (* m_multiplyAdd)(const double *, double, double *, int);
+	void (* m_multiply)(const double *, const double *, double *, int);
+	void (* m_scale)(const double *, double, double *, int);
+	void (* m_clip)(const double *, double, double, double *, int);
+	double (* m_sumAbs)(const double *, int);
+	double (* m_peak)(const double *, int);
+	double (* m_dotProduct)(const double *, const double *, int);
+	void (* m_fir)(const double *, const double *, int, double *, int);
+};
+
+//Plain versions, used when there is no SIMD, and for the leftover samples at the end of the SIMD versions.
+static void addScalar(const double * source, double * destination, int samples) {
+	for (int i = 0; i < samples; i++)
+		destination[i] += source[i];
+}
+
+static void multiplyAddScalar(const double * source, double factor, double * destination, int samples) {
+	for (int i = 0; i < samples; i++)
+		destination[i] += source[i] * factor;
+}
+
+static void multiplyScalar(const double * source1, const double * source2, double * destination, int samples) {
+	for (int i = 0; i < samples; i++)
+		destination[i] = source1[i] * source2[i];
+}
+
+static void scaleScalar(const double * source, double factor, double * destination, int samples) {
+	for (int i = 0; i < samples; i++)
+		destination[i] = source[i] * factor;
+}
+
+static void clipScalar(const double * source, double min, double max, double * destination, int samples) {
+	for (int i = 0; i < samples; i++)
+		destination[i] = clip(source[i], min, max);
+}
+
+static double sumAbsScalar(const double * source, int samples) {
+	double total = 0.0;
+	for (int i = 0; i < samples; i++)
+		total += std::fabs(source[i]);
+	return total;
+}
+
+static double peakScalar(const double * source, int samples) {
+	double peak = 0.0;
+	for (int i = 0; i < samples; i++)
+		peak = std::max(peak, std::fabs(source[i]));
+	return peak;
+}
+
+static double dotProductScalar(const double * source1, const double * source2, int samples) {
+	double total = 0.0;
+	for (int i = 0; i < samples; i++)
+		total += source1[i] * source2[i];
+	return total;
+}
+
+//The FIR versions compute several outputs per pass over the coefficients, so each coefficient is loaded once for all of them.
+static void firScalar(const double * input, const double * coefficients, int taps, double * output, int samples) {
+	int s = 0;
+	for (; s + 4 <= samples; s += 4) {
+		const double * in = input + s;
+		double total0 = 0.0, total1 = 0.0, total2 = 0.0, total3 = 0.0;
+		for (int j = 0; j < taps; j++) {
+			double c = coefficients[j];
+			total0 += in[j] * c;
+			total1 += in[j + 1] * c;
+			total2 += in[j + 2] * c;
+			total3 += in[j + 3] * c;
+		}
+		output[s] = total0;
+		output[s + 1] = total1;
+		output[s + 2] = total2;
+		output[s + 3] = total3;
+	}
+	for (; s < samples; s++)
+		output[s] = dotProductScalar(input + s, coefficients, taps);
+}
+
+#ifdef ADSP_VECTOR_X86
+/* SSE2 */
+
+static void addSse2(const double * source, double * destination, int samples) {
+	int i = 0;
+	for (; i + 2 <= samples; i += 2)
+		_mm_storeu_pd(destination + i, _mm_add_pd(_mm_loadu_pd(destination + i), _mm_loadu_pd(source + i)));
+	addScalar(source + i, destination + i, samples - i);
+}
+
+static void multiplyAddSse2(const double * source, double factor, double * destination, int samples) {
+	__m128d f = _mm_set1_pd(factor);
+	int i = 0;
+	for (; i + 2 <= samples; i += 2)
+		_mm_storeu_pd(destination + i, _mm_add_pd(_mm_loadu_pd(destination + i), _mm_mul_pd(_mm_loadu_pd(source + i), f)));
+	multiplyAddScalar(source + i, factor, destination + i, samples - i);
+}
+
+static void multiplySse2(const double * source1, const double * source2, double * destination, int samples) {
+	int i = 0;
+	for (; i + 2 <= samples; i += 2)
+		_mm_storeu_pd(destination + i, _mm_mul_pd(_mm_loadu_pd(source1 + i), _mm_loadu_pd(source2 + i)));
+	multiplyScalar(source1 + i, source2 + i, destination + i, samples - i);
+}
+
+static void scaleSse2(const double * source, double factor, double * destination, int samples) {
+	__m128d f = _mm_set1_pd(factor);
+	int i = 0;
+	for (; i + 2 <= samples; i += 2)
+		_mm_storeu_pd(destination + i, _mm_mul_pd(_mm_loadu_pd(source + i), f));
+	scaleScalar(source + i, factor, destination + i, samples - i);
+}
+
+static void clipSse2(const double * source, double min, double max, double * destination, int samples) {
+	__m128d lo = _mm_set1_pd(min), hi = _mm_set1_pd(max);
+	int i = 0;
+	for (; i + 2 <= samples; i += 2)
+		_mm_storeu_pd(destination + i, _mm_min_pd(_mm_max_pd(_mm_loadu_pd(source + i), lo), hi));
+	clipScalar(source + i, min, max, destination + i, samples - i);
+}
+
+static double sumAbsSse2(const double * source, int samples) {
+	__m128d mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL)), total = _mm_setzero_pd();
+	int i = 0;
+	for (; i + 2 <= samples; i += 2)
+		total = _mm_add_pd(total, _mm_and_pd(_mm_loadu_pd(source + i), mask));
+	double lanes[2];
+	_mm_storeu_pd(lanes, total);
+	return lanes[0] + lanes[1] + sumAbsScalar(source + i, samples - i);
+}
+
+static double peakSse2(const double * source, int samples) {
+	__m128d mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL)), peak = _mm_setzero_pd();
+	int i = 0;
+	for (; i + 2 <= samples; i += 2)
+		peak = _mm_max_pd(peak, _mm_and_pd(_mm_loadu_pd(source + i), mask));
+	double lanes[2];
+	_mm_storeu_pd(lanes, peak);
+	return std::max(std::max(lanes[0], lanes[1]), peakScalar(source + i, samples - i));
+}
+
+static double dotProductSse2(const double * source1, const double * source2, int samples) {
+	//Two accumulators, so that each add doesn't have to wait for the last one.
+	__m128d total1 = _mm_setzero_pd(), total2 = _mm_setzero_pd();
+	int i = 0;
+	for (; i + 4 <= samples; i += 4) {
+		total1 = _mm_add_pd(total1, _mm_mul_pd(_mm_loadu_pd(source1 + i), _mm_loadu_pd(source2 + i)));
+		total2 = _mm_add_pd(total2, _mm_mul_pd(_mm_loadu_pd(source1 + i + 2), _mm_loadu_pd(source2 + i + 2)));
+	}
+	double lanes[2];
+	_mm_storeu_pd(lanes, _mm_add_pd(total1, total2));
+	return lanes[0] + lanes[1] + dotProductScalar(source1 + i, source2 + i, samples - i);
+}
+
+static void firSse2(const double * input, const double * coefficients, int taps, double * output, int samples) {
+	int s = 0;
+	for (; s + 8 <= samples; s += 8) {
+		const double * in = input + s;
+		__m128d total0 = _mm_setzero_pd(), total1 = _mm_setzero_pd(), total2 = _mm_setzero_pd(), total3 = _mm_setzero_pd();
+		for (int j = 0; j < taps; j++) {
+			__m128d c = _mm_set1_pd(coefficients[j]);
+			total0 = _mm_add_pd(total0, _mm_mul_pd(_mm_loadu_pd(in + j), c));
+			total1 = _mm_add_pd(total1, _mm_mul_pd(_mm_loadu_pd(in + j + 2), c));
+			total2 = _mm_add_pd(total2, _mm_mul_pd(_mm_loadu_pd(in + j + 4), c));
+			total3 = _mm_add_pd(total3, _mm_mul_pd(_mm_loadu_pd(in + j + 6), c));
+		}
+		_mm_storeu_pd(output + s, total0);
+		_mm_storeu_pd(output + s + 2, total1);
+		_mm_storeu_pd(output + s + 4, total2);
+		_mm_storeu_pd(output + s + 6, total3);
+	}
+	for (; s < samples; s++)
+		output[s] = dotProductSse2(input + s, coefficients, taps);
+}
+
+/* AVX */
+
+ADSP_TARGET_AVX static void addAvx(const double * source, double * destination, int samples) {
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_add_pd(_mm256_loadu_pd(destination + i), _mm256_loadu_pd(source + i)));
+	addScalar(source + i, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX static void multiplyAddAvx(const double * source, double factor, double * destination, int samples) {
+	__m256d f = _mm256_set1_pd(factor);
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_add_pd(_mm256_loadu_pd(destination + i), _mm256_mul_pd(_mm256_loadu_pd(source + i), f)));
+	multiplyAddScalar(source + i, factor, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX static void multiplyAvx(const double * source1, const double * source2, double * destination, int samples) {
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_mul_pd(_mm256_loadu_pd(source1 + i), _mm256_loadu_pd(source2 + i)));
+	multiplyScalar(source1 + i, source2 + i, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX static void scaleAvx(const double * source, double factor, double * destination, int samples) {
+	__m256d f = _mm256_set1_pd(factor);
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_mul_pd(_mm256_loadu_pd(source + i), f));
+	scaleScalar(source + i, factor, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX static void clipAvx(const double * source, double min, double max, double * destination, int samples) {
+	__m256d lo = _mm256_set1_pd(min), hi = _mm256_set1_pd(max);
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(source + i), lo), hi));
+	clipScalar(source + i, min, max, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX static double sumAbsAvx(const double * source, int samples) {
+	__m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL)), total = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		total = _mm256_add_pd(total, _mm256_and_pd(_mm256_loadu_pd(source + i), mask));
+	double lanes[4];
+	_mm256_storeu_pd(lanes, total);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumAbsScalar(source + i, samples - i);
+}
+
+ADSP_TARGET_AVX static double peakAvx(const double * source, int samples) {
+	__m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL)), peak = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		peak = _mm256_max_pd(peak, _mm256_and_pd(_mm256_loadu_pd(source + i), mask));
+	double lanes[4];
+	_mm256_storeu_pd(lanes, peak);
+	return std::max(std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3])), peakScalar(source + i, samples - i));
+}
+
+ADSP_TARGET_AVX static double dotProductAvx(const double * source1, const double * source2, int samples) {
+	__m256d total1 = _mm256_setzero_pd(), total2 = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		total1 = _mm256_add_pd(total1, _mm256_mul_pd(_mm256_loadu_pd(source1 + i), _mm256_loadu_pd(source2 + i)));
+		total2 = _mm256_add_pd(total2, _mm256_mul_pd(_mm256_loadu_pd(source1 + i + 4), _mm256_loadu_pd(source2 + i + 4)));
+	}
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_add_pd(total1, total2));
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotProductScalar(source1 + i, source2 + i, samples - i);
+}
+
+ADSP_TARGET_AVX static void firAvx(const double * input, const double * coefficients, int taps, double * output, int samples) {
+	int s = 0;
+	for (; s + 16 <= samples; s += 16) {
+		const double * in = input + s;
+		__m256d total0 = _mm256_setzero_pd(), total1 = _mm256_setzero_pd(), total2 = _mm256_setzero_pd(), total3 = _mm256_setzero_pd();
+		for (int j = 0; j < taps; j++) {
+			__m256d c = _mm256_broadcast_sd(coefficients + j);
+			total0 = _mm256_add_pd(total0, _mm256_mul_pd(_mm256_loadu_pd(in + j), c));
+			total1 = _mm256_add_pd(total1, _mm256_mul_pd(_mm256_loadu_pd(in + j + 4), c));
+			total2 = _mm256_add_pd(total2, _mm256_mul_pd(_mm256_loadu_pd(in + j + 8), c));
+			total3 = _mm256_add_pd(total3, _mm256_mul_pd(_mm256_loadu_pd(in + j + 12), c));
+		}
+		_mm256_storeu_pd(output + s, total0);
+		_mm256_storeu_pd(output + s + 4, total1);
+		_mm256_storeu_pd(output + s + 8, total2);
+		_mm256_storeu_pd(output + s + 12, total3);
+	}
+	for (; s < samples; s++)
+		output[s] = dotProductAvx(input + s, coefficients, taps);
+}
+
+/* AVX2 (Only the operations that benefit from FMA are different from AVX.) */
+
+ADSP_TARGET_AVX2 static void multiplyAddAvx2(const double * source, double factor, double * destination, int samples) {
+	__m256d f = _mm256_set1_pd(factor);
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_fmadd_pd(_mm256_loadu_pd(source + i), f, _mm256_loadu_pd(destination + i)));
+	multiplyAddScalar(source + i, factor, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX2 static double dotProductAvx2(const double * source1, const double * source2, int samples) {
+	__m256d total1 = _mm256_setzero_pd(), total2 = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		total1 = _mm256_fmadd_pd(_mm256_loadu_pd(source1 + i), _mm256_loadu_pd(source2 + i), total1);
+		total2 = _mm256_fmadd_pd(_mm256_loadu_pd(source1 + i + 4), _mm256_loadu_pd(source2 + i + 4), total2);
+	}
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_add_pd(total1, total2));
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotProductScalar(source1 + i, source2 + i, samples - i);
+}
+
+ADSP_TARGET_AVX2 static void firAvx2(const double * input, const double * coefficients, int taps, double * output, int samples) {
+	int s = 0;
+	for (; s + 16 <= samples; s += 16) {
+		const double * in = input + s;
+		__m256d total0 = _mm256_setzero_pd(), total1 = _mm256_setzero_pd(), total2 = _mm256_setzero_pd(), total3 = _mm256_setzero_pd();
+		for (int j = 0; j < taps; j++) {
+			__m256d c = _mm256_broadcast_sd(coefficients + j);
+			total0 = _mm256_fmadd_pd(_mm256_loadu_pd(in + j), c, total0);
+			total1 = _mm256_fmadd_pd(_mm256_loadu_pd(in + j + 4), c, total1);
+			total2 = _mm256_fmadd_pd(_mm256_loadu_pd(in + j + 8), c, total2);
+			total3 = _mm256_fmadd_pd(_mm256_loadu_pd(in + j + 12), c, total3);
+		}
+		_mm256_storeu_pd(output + s, total0);
+		_mm256_storeu_pd(output + s + 4, total1);
+		_mm256_storeu_pd(output + s + 8, total2);
+		_mm256_storeu_pd(output + s + 12, total3);
+	}
+	for (; s < samples; s++)
+		output[s] = dotProductAvx2(input + s, coefficients, taps);
+}
+
+/* AVX-512 (GCC 12 warns that the unmasked min, max and reduce intrinsics
+ * read an uninitialized vector, so min and max use the zero-masked forms
+ * with every lane enabled, and sums are reduced through memory like AVX.) */
+
+#define ALL_LANES __mmask8(0xFF)
+
+ADSP_TARGET_AVX512 static void addAvx512(const double * source, double * destination, int samples) {
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		_mm512_storeu_pd(destination + i, _mm512_add_pd(_mm512_loadu_pd(destination + i), _mm512_loadu_pd(source + i)));
+	addScalar(source + i, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX512 static void multiplyAddAvx512(const double * source, double factor, double * destination, int samples) {
+	__m512d f = _mm512_set1_pd(factor);
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		_mm512_storeu_pd(destination + i, _mm512_fmadd_pd(_mm512_loadu_pd(source + i), f, _mm512_loadu_pd(destination + i)));
+	multiplyAddScalar(source + i, factor, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX512 static void multiplyAvx512(const double * source1, const double * source2, double * destination, int samples) {
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		_mm512_storeu_pd(destination + i, _mm512_mul_pd(_mm512_loadu_pd(source1 + i), _mm512_loadu_pd(source2 + i)));
+	multiplyScalar(source1 + i, source2 + i, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX512 static void scaleAvx512(const double * source, double factor, double * destination, int samples) {
+	__m512d f = _mm512_set1_pd(factor);
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		_mm512_storeu_pd(destination + i, _mm512_mul_pd(_mm512_loadu_pd(source + i), f));
+	scaleScalar(source + i, factor, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX512 static void clipAvx512(const double * source, double min, double max, double * destination, int samples) {
+	__m512d lo = _mm512_set1_pd(min), hi = _mm512_set1_pd(max);
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		_mm512_storeu_pd(destination + i, _mm512_maskz_min_pd(ALL_LANES, _mm512_maskz_max_pd(ALL_LANES, _mm512_loadu_pd(source + i), lo), hi));
+	clipScalar(source + i, min, max, destination + i, samples - i);
+}
+
+ADSP_TARGET_AVX512 static double sumAbsAvx512(const double * source, int samples) {
+	__m512d total = _mm512_setzero_pd();
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		total = _mm512_add_pd(total, _mm512_abs_pd(_mm512_loadu_pd(source + i)));
+	double lanes[8];
+	_mm512_storeu_pd(lanes, total);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7] + sumAbsScalar(source + i, samples - i);
+}
+
+ADSP_TARGET_AVX512 static double peakAvx512(const double * source, int samples) {
+	__m512d peak = _mm512_setzero_pd();
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		peak = _mm512_maskz_max_pd(ALL_LANES, peak, _mm512_abs_pd(_mm512_loadu_pd(source + i)));
+	double lanes[8];
+	_mm512_storeu_pd(lanes, peak);
+	return std::max(*std::max_element(lanes, lanes + 8), peakScalar(source + i, samples - i));
+}
+
+ADSP_TARGET_AVX512 static double dotProductAvx512(const double * source1, const double * source2, int samples) {
+	__m512d total1 = _mm512_setzero_pd(), total2 = _mm512_setzero_pd();
+	int i = 0;
+	for (; i + 16 <= samples; i += 16) {
+		total1 = _mm512_fmadd_pd(_mm512_loadu_pd(source1 + i), _mm512_loadu_pd(source2 + i), total1);
+		total2 = _mm512_fmadd_pd(_mm512_loadu_pd(source1 + i + 8), _mm512_loadu_pd(source2 + i + 8), total2);
+	}
+	double lanes[8];
+	_mm512_storeu_pd(lanes, _mm512_add_pd(total1, total2));
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7] + dotProductScalar(source1 + i, source2 + i, samples - i);
+}
+
+ADSP_TARGET_AVX512 static void firAvx512(const double * input, const double * coefficients, int taps, double * output, int samples) {
+	int s = 0;
+	for (; s + 32 <= samples; s += 32) {
+		const double * in = input + s;
+		__m512d total0 = _mm512_setzero_pd(), total1 = _mm512_setzero_pd(), total2 = _mm512_setzero_pd(), total3 = _mm512_setzero_pd();
+		for (int j = 0; j < taps; j++) {
+			__m512d c = _mm512_set1_pd(coefficients[j]);
+			total0 = _mm512_fmadd_pd(_mm512_loadu_pd(in + j), c, total0);
+			total1 = _mm512_fmadd_pd(_mm512_loadu_pd(in + j + 8), c, total1);
+			total2 = _mm512_fmadd_pd(_mm512_loadu_pd(in + j + 16), c, total2);
+			total3 = _mm512_fmadd_pd(_mm512_loadu_pd(in + j + 24), c, total3);
+		}
+		_mm512_storeu_pd(output + s, total0);
+		_mm512_storeu_pd(output + s + 8, total1);
+		_mm512_storeu_pd(output + s + 16, total2);
+		_mm512_storeu_pd(output + s + 24, total3);
+	}
+	//AVX2 is always there when AVX-512 is, and does the leftovers 16 at a time.
+	firAvx2(input + s, coefficients, taps, output + s, samples - s);
+}
+
+#undef ALL_LANES
+#endif
+
+/**
+ * Kernels for each SimdLevel, in the same order as SimdLevel.
+ */
+static const VectorKernels KERNELS[] = {
+	{ addScalar, multiplyAddScalar, multiplyScalar, scaleScalar, clipScalar, sumAbsScalar, peakScalar, dotProductScalar, firScalar },
+#ifdef ADSP_VECTOR_X86
+	{ addSse2, multiplyAddSse2, multiplySse2, scaleSse2, clipSse2, sumAbsSse2, peakSse2, dotProductSse2, firSse2 },
+	{ addAvx, multiplyAddAvx, multiplyAvx, scaleAvx, clipAvx, sumAbsAvx, peakAvx, dotProductAvx, firAvx },
+	{ addAvx, multiplyAddAvx2, multiplyAvx, scaleAvx, clipAvx, sumAbsAvx, peakAvx, dotProductAvx2, firAvx2 },
+	{ addAvx512, multiplyAddAvx512, multiplyAvx512, scaleAvx512, clipAvx512, sumAbsAvx512, peakAvx512, dotProductAvx512, firAvx512 },
+#endif
+};
+
+static constexpr int NUM_KERNELS = sizeof(KERNELS) / sizeof(KERNELS[0]);
+
+static const VectorKernels & getKernels() {
+	//Without x86 SIMD only the scalar kernels are compiled, but the CPU (e.g. a 32 bit build
+	//without SSE2) can still report a higher level, so fall back to the best one there is.
+	int level = int(getSimdLevel());
+	return KERNELS[(level < NUM_KERNELS) ? level : NUM_KERNELS - 1];
+}
+
+void copyBlock(const double * source, double * destination, int samples) {
+	//std::copy already turns into memmove, which runs as fast as memory allows.
+	if (source != destination)
+		std::copy(source, source + samples, destination);
+}
+
+void fillBlock(double * destination, double value, int samples) {
+	std::fill(destination, destination + samples, value);
+}
+
+void addBlock(const double * source, double * destination, int samples) {
+	getKernels().m_add(source, destination, samples);
+}
+
+void multiplyAddBlock(const double * source, double factor, double * destination, int samples) {
+	getKernels().m_multiplyAdd(source, factor, destination, samples);
+}
+
+void multiplyBlock(const double * source1, const double * source2, double * destination, int samples) {
+	getKernels().m_multiply(source1, source2, destination, samples);
+}
+
+void scaleBlock(const double * source, double factor, double * destination, int samples) {
+	getKernels().m_scale(source, factor, destination, samples);
+}
+
+void clipBlock(const double * source, double min, double max, double * destination, int samples) {
+	getKernels().m_clip(source, min, max, destination, samples);
+}
+
+void panBlock(const double * source, double panning, double * left, double * right, int samples) {
+	//Right first, in case left is the same block as source.
+	getKernels().m_scale(source, panRightAmplitude(panning), right, samples);
+	getKernels().m_scale(source, panLeftAmplitude(panning), left, samples);
+}
+
+double sumAbsBlock(const double * source, int samples) {
+	return getKernels().m_sumAbs(source, samples);
+}
+
+double peakBlock(const double * source, int samples) {
+	return getKernels().m_peak(source, samples);
+}
+
+double dotProductBlock(const double * source1, const double * source2, int samples) {
+	return getKernels().m_dotProduct(source1, source2, samples);
+}
+
+void firBlock(const double * input, const double * coefficients, int taps, double * output, int samples) {
+	getKernels().m_fir(input, coefficients, taps, output, samples);
+}
+
+} /* namespace Adsp */
@@ -0,0 +1,133 @@
+/*
+ * Vector.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_VECTOR_H_
+#define SOURCE_ADSP_VECTOR_H_
+
+namespace Adsp {
+/**
+ * @defgroup vector
+ * @ingroup Adsp
+ * Operations on whole blocks of samples at once. These use
+ * the widest SIMD instructions the CPU running the synth
+ * supports. (See @ref cpu.) Source and destination blocks
+ * can be the same block, but should not partially overlap.
+ * @{
+ */
+
+/**
+ * Copies a block of samples.
+ * @param source The samples to copy.
+ * @param destination Where to copy the samples to.
+ * @param samples How many samples to copy.
+ */
+void copyBlock(const double * source, double * destination, int samples);
+/**
+ * Sets every sample in a block to the same value.
+ * @param destination The samples to set.
+ * @param value The value to set every sample to.
+ * @param samples How many samples to set.
+ */
+void fillBlock(double * destination, double value, int samples);
+/**
+ * Adds a block of samples to another block.
+ * (destination = destination + source)
+ * @param source The samples to add.
+ * @param destination The samples to add to.
+ * @param samples How many samples to add.
+ */
+void addBlock(const double * source, double * destination, int samples);
+/**
+ * Adds an amplified block of samples to another block.
+ * (destination = destination + source * factor)
+ * @param source The samples to amplify and add.
+ * @param factor How much to amplify source by.
+ * @param destination The samples to add to.
+ * @param samples How many samples to process.
+ */
+void multiplyAddBlock(const double * source, double factor, double * destination, int samples);
+/**
+ * Multiplies two blocks of samples together, one sample
+ * at a time. (destination = source1 * source2)
+ * @param source1 The first block of samples.
+ * @param source2 The second block of samples.
+ * @param destination Where to put the result.
+ * @param samples How many samples to process.
+ */
+void multiplyBlock(const double * source1, const double * source2, double * destination, int samples);
+/**
+ * Amplifies a block of samples.
+ * (destination = source * factor)
+ * @param source The samples to amplify.
+ * @param factor How much to amplify the samples by.
+ * @param destination Where to put the result.
+ * @param samples How many samples to process.
+ */
+void scaleBlock(const double * source, double factor, double * destination, int samples);
+/**
+ * Hard clips a block of samples. See clip().
+ * @param source The samples to clip.
+ * @param min The lowest value a sample can have.
+ * @param max The highest value a sample can have.
+ * @param destination Where to put the result.
+ * @param samples How many samples to process.
+ */
+void clipBlock(const double * source, double min, double max, double * destination, int samples);
+/**
+ * Pans a block of mono samples into a left and a right
+ * block, using panLeftAmplitude() and panRightAmplitude().
+ * @param source The samples to pan.
+ * @param panning A double between -1 and 1, with -1 being left and 1 being right.
+ * @param left Where to put the left channel.
+ * @param right Where to put the right channel.
+ * @param samples How many samples to process.
+ */
+void panBlock(const double * source, double panning, double * left, double * right, int samples);
+/**
+ * Adds up the absolute values of a block of samples.
+ * @param source The samples to add up.
+ * @param samples How many samples there are.
+ * @return The sum of the absolute value of every sample.
+ */
+double sumAbsBlock(const double * source, int samples);
+/**
+ * Finds the loudest sample in a block.
+ * @param source The samples to search.
+ * @param samples How many samples there are.
+ * @return The largest absolute value of any sample, or 0 if there are no samples.
+ */
+double peakBlock(const double * source, int samples);
+
+/**
+ * Multiplies two blocks of samples together, one sample
+ * at a time, and adds up the results. This is the core
+ * of an FIR filter.
+ * @param source1 The first block of samples.
+ * @param source2 The second block of samples.
+ * @param samples How many samples there are in each block.
+ * @return The sum of source1[i] * source2[i].
+ */
+double dotProductBlock(const double * source1, const double * source2, int samples);
+/**
+ * Runs an FIR filter over a block of samples. This gives
+ * the same result (apart from rounding) as calling
+ * dotProductBlock() once for every output sample, but it
+ * computes several outputs per pass over the
+ * coefficients, so each coefficient is loaded once per
+ * group of outputs instead of once per output.
+ * @param input The samples to filter. Output sample i is filtered from input samples i to i + taps - 1, so there must be samples + taps - 1 of them.
+ * @param coefficients The filter coefficients, starting with the one for the oldest sample.
+ * @param taps How many coefficients there are.
+ * @param output Where to put the filtered samples. Must not overlap input.
+ * @param samples How many samples of output to compute.
+ */
+void firBlock(const double * input, const double * coefficients, int taps, double * output, int samples);
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_VECTOR_H_ */
@@ -7,8 +7,11 @@
 
 #include "Waveform.h"
 
+#include <algorithm>
 #include <cmath>
 
+#include "FastMath.h"
+
 namespace Adsp {
 
 inline double fastPow(double a, double b) {
@@ -23,7 +26,7 @@ inline double fastPow(double a, double b) {
 
 //Calculates a sine wave at the given phase.
 double sineWave(double phase) {
-	return sin(phase * M_PI);
+	return fastSinPi(phase);
 }
 
 //Calculates a square wave at the given phase. It is low before 0.0, and high after.
@@ -36,6 +39,45 @@ double triWave(double phase) {
 	return phase * ((phase > 0.0) ? -2.0 : 2.0) + 1.0;
 }
 
+/**
+ * How many samples past a corner of a wave the phase is,
+ * between -1 / increment and 1 / increment. The distance
+ * wraps around, so the corner at 1 is also at -1.
+ */
+static double samplesSinceCorner(double phase, double corner, double inverseIncrement) {
+	return (std::fmod(phase - corner + 11.0, 2.0) - 1.0) * inverseIncrement;
+}
+
+//Residual of a band limited jump from -1 to 1, t samples after the jump.
+static double polyBlep(double t) {
+	if (t <= -1.0 || t >= 1.0)
+		return 0.0;
+	return (t < 0.0) ? (t + 1.0) * (t + 1.0) : -(1.0 - t) * (1.0 - t);
+}
+
+//Residual of a band limited corner whose slope goes up by 1 per sample, t samples after the corner.
+static double polyBlamp(double t) {
+	double closeness = 1.0 - std::fabs(t);
+	return (closeness > 0.0) ? closeness * closeness * closeness / 6.0 : 0.0;
+}
+
+double squareWaveBlep(double phase, double center, double increment) {
+	double inverseIncrement = 1.0 / std::max(std::min(std::fabs(increment), 1.0), 1.0e-9);
+	//Below the center, the moved phase is below 0, so it jumps up at the center and back down at the end.
+	double value = (phase > center) ? 1.0 : -1.0;
+	return value + polyBlep(samplesSinceCorner(phase, center, inverseIncrement)) - polyBlep(samplesSinceCorner(phase, 1.0, inverseIncrement));
+}
+
+double triWaveBlamp(double phase, double center, double increment) {
+	double dt = std::max(std::min(std::fabs(increment), 1.0), 1.0e-9);
+	center = std::max(-1.0 + dt, std::min(1.0 - dt, center));
+	double inverseIncrement = 1.0 / dt;
+	double value = (phase <= center) ? 2.0 * (phase + 1.0) / (center + 1.0) - 1.0 : 1.0 - 2.0 * (phase - center) / (1.0 - center);
+	//The slope goes from 2 / (center + 1) to -2 / (1 - center) and back, per unit of phase.
+	double rampScale = 4.0 * dt / (1.0 - center * center);
+	return value + rampScale * (polyBlamp(samplesSinceCorner(phase, 1.0, inverseIncrement)) - polyBlamp(samplesSinceCorner(phase, center, inverseIncrement)));
+}
+
 //Calculates an exponential wave.
 //Var is remapped from -1.0 - 1.0 to 0.3 - 4.3. Therefore, for a straight line, do -0.65.
 double expWave(double phase, double var) {
@@ -70,14 +112,14 @@ double expCrestWave(double phase, double var) {
 //Var is remapped from -1.0 - 1.0 to 0.5 - 2.5.
 double tanhWave(double phase, double var) {
 	var += 1.5;
-	return tanh(phase * var) / tanh(var);
+	return fastTanh(phase * var) / fastTanh(var);
 }
 
 //Calculates a symmetrical tanh wave (two tanh waves, mirrored, stuck end to end)
 //Var is remapped from -1.0 - 1.0 to 0.5 - 2.5.
 double tanhSymmWave(double phase, double var) {
 	var += 1.5;
-	return tanh((phase * ((phase < 0.0) ? 2.0 : -2.0) + 1.0) * var) / tanh(var);
+	return fastTanh((phase * ((phase < 0.0) ? 2.0 : -2.0) + 1.0) * var) / fastTanh(var);
 }
 
 } /* namespace Adsp */
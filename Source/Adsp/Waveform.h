@@ -41,6 +41,33 @@ double squareWave(double phase);
  */
 double triWave(double phase);
 
+/**
+ * Computes a square wave with phase 0 moved to center, the
+ * same way BasicOsc moves it, which makes a pulse wave. Both
+ * jumps are smoothed with polyBLEPs (a polynomial
+ * approximation of a band limited step), which gets rid of
+ * most of the aliasing for a few extra flops per sample.
+ * @param phase Phase value, from -1 to 1, before it is moved by center.
+ * @param center Where phase 0 is moved to, from -1 to 1.
+ * @param increment How much the phase changes every sample.
+ * @return Computed square wave, from about -1 to 1.
+ */
+double squareWaveBlep(double phase, double center, double increment);
+
+/**
+ * Computes a triangle wave with phase 0 moved to center,
+ * the same way BasicOsc moves it. Both corners are smoothed
+ * with polyBLAMPs (the integral of a polyBLEP), which gets
+ * rid of most of the aliasing. The center is kept at least
+ * one sample away from the ends of the wave, so a center of
+ * 1 makes a band limited saw wave instead of a perfect one.
+ * @param phase Phase value, from -1 to 1, before it is moved by center.
+ * @param center Where phase 0 is moved to, from -1 to 1.
+ * @param increment How much the phase changes every sample.
+ * @return Computed triangle wave, from about -1 to 1.
+ */
+double triWaveBlamp(double phase, double center, double increment);
+
 //Calculates an exponential wave.
 //Var is remapped from -1.0 - 1.0 to 0.3 - 4.3. Therefore, for a straight line, do -0.65.
 /**
@@ -0,0 +1,180 @@
+/*
+ * Wavetable.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Wavetable.h"
+
+#include <algorithm>
+#include <complex>
+
+#include "Fft.h"
+#include "Waveform.h"
+
+namespace Adsp {
+
+/**
+ * Computes one of the waveforms from Waveform.h, the same way
+ * BasicOscAtom does.
+ */
+static double computeWave(int waveform, double phase, double variable) {
+	switch (waveform) {
+	case 0:
+		return sineWave(phase);
+	case 1:
+		return squareWave(phase);
+	case 2:
+		return triWave(phase);
+	case 3:
+		return expWave(phase, variable);
+	case 4:
+		return expSymmWave(phase, variable);
+	case 5:
+		return expCrestWave(phase, variable);
+	case 6:
+		return tanhWave(phase, variable);
+	case 7:
+		return tanhSymmWave(phase, variable);
+	default:
+		return 0.2;
+	}
+}
+
+Wavetable::Wavetable(int waveform, double variable, double center) :
+		m_samples(MIP_LEVELS * (TABLE_SIZE + 1)) {
+	//Render the raw waveform with lots of extra samples, so that the harmonics that are kept do not have much aliasing in them.
+	constexpr int RENDER_SIZE = TABLE_SIZE * OVERSAMPLING;
+	static const Fft renderFft(RENDER_SIZE), tableFft(TABLE_SIZE);
+	std::vector<std::complex<double>> spectrum(RENDER_SIZE), level(TABLE_SIZE);
+	for (int i = 0; i < RENDER_SIZE; i++) {
+		double phase = 2.0 * i / RENDER_SIZE - 1.0;
+		if (phase <= center) {
+			phase = (phase + 1.0) / (center + 1.0 + 1.0e-64) - 1.0;
+		} else {
+			phase = (phase - center) / (1.0 - center);
+		}
+		spectrum[i] = computeWave(waveform, phase, variable);
+	}
+	renderFft.forward(spectrum.data());
+
+	for (int l = 0; l < MIP_LEVELS; l++) {
+		//The nyquist bin is left out, it can't be played back without aliasing anyway.
+		int harmonics = std::min(TABLE_SIZE / 2 - 1, (TABLE_SIZE / 2) >> l);
+		std::fill(level.begin(), level.end(), std::complex<double>(0.0));
+		level[0] = spectrum[0];
+		for (int k = 1; k <= harmonics; k++) {
+			level[k] = spectrum[k];
+			level[TABLE_SIZE - k] = spectrum[RENDER_SIZE - k];
+		}
+		tableFft.inverse(level.data());
+		double * samples = &m_samples[l * (TABLE_SIZE + 1)];
+		for (int i = 0; i < TABLE_SIZE; i++) {
+			samples[i] = level[i].real() / RENDER_SIZE;
+		}
+		samples[TABLE_SIZE] = samples[0];
+	}
+}
+
+WavetableCache * WavetableCache::s_instance = nullptr;
+
+WavetableCache::WavetableCache() :
+		m_tables(new std::atomic<Wavetable *>[NUM_KEYS]),
+		m_users(new std::atomic<int>[NUM_KEYS]),
+		m_requested(new std::atomic<bool>[NUM_KEYS]),
+		m_anyRequested(false) {
+	for (int key = 0; key < NUM_KEYS; key++) {
+		m_tables[key].store(nullptr);
+		m_users[key].store(0);
+		m_requested[key].store(false);
+	}
+}
+
+WavetableCache * WavetableCache::getInstance() {
+	if (s_instance == nullptr) {
+		s_instance = new WavetableCache();
+	}
+	return s_instance;
+}
+
+WavetableCache::~WavetableCache() {
+	for (int key = 0; key < NUM_KEYS; key++) {
+		delete m_tables[key].load();
+	}
+	for (Retired & retired : m_retired) {
+		delete retired.m_table;
+	}
+}
+
+/**
+ * Rounds a parameter between -1 and 1 to an integer between
+ * 0 and WavetableCache::VALUES - 1.
+ */
+static int quantize(double value) {
+	value = std::max(-1.0, std::min(1.0, value)); //NaNs become 1.
+	return int(std::lround((value + 1.0) * WavetableCache::QUANTIZE_STEPS));
+}
+
+int WavetableCache::getKey(int waveform, double variable, double center) {
+	int variableIndex = (waveform <= 2) ? 0 : quantize(variable); //Sine, square and triangle have no var parameter.
+	return (waveform * VALUES + variableIndex) * VALUES + quantize(center);
+}
+
+const Wavetable * WavetableCache::acquire(int key) {
+	Wavetable * table = m_tables[key].load();
+	if (table != nullptr) {
+		m_users[key].fetch_add(1);
+		//evict() removes the table before checking m_users, so if it is still here, evict() will see that it is in use.
+		if (m_tables[key].load() == table) {
+			return table;
+		}
+		m_users[key].fetch_sub(1);
+	}
+	request(key);
+	return nullptr;
+}
+
+void WavetableCache::evict() {
+	//Tables that were removed while being acquired can be deleted once nothing uses them any more.
+	for (int i = int(m_retired.size()) - 1; i >= 0; i--) {
+		if (m_users[m_retired[i].m_key].load() == 0) {
+			delete m_retired[i].m_table;
+			m_retired.erase(m_retired.begin() + i);
+		}
+	}
+	for (auto key = m_rendered.begin(); key != m_rendered.end() && int(m_rendered.size()) > MAX_TABLES;) {
+		if (m_users[*key].load() != 0) {
+			key++; //Still being played, the oscillator playing it will move to a different table eventually.
+			continue;
+		}
+		Wavetable * table = m_tables[*key].exchange(nullptr);
+		if (m_users[*key].load() == 0) {
+			delete table;
+		} else {
+			m_retired.push_back( { *key, table }); //acquire() got it just before it was removed.
+		}
+		key = m_rendered.erase(key);
+	}
+}
+
+bool WavetableCache::renderRequested() {
+	if (!m_anyRequested.exchange(false)) {
+		return false;
+	}
+	for (int key = 0; key < NUM_KEYS; key++) {
+		if (m_requested[key].load(std::memory_order_relaxed) && m_requested[key].exchange(false) && m_tables[key].load() == nullptr) {
+			int waveform = key / (VALUES * VALUES);
+			double variable = double((key / VALUES) % VALUES) / QUANTIZE_STEPS - 1.0;
+			double center = double(key % VALUES) / QUANTIZE_STEPS - 1.0;
+			m_tables[key].store(new Wavetable(waveform, variable, center));
+			m_rendered.push_back(key);
+			evict();
+			m_anyRequested.store(true); //There might be more, look again next time.
+			return true;
+		}
+	}
+	evict();
+	return true;
+}
+
+} /* namespace Adsp */
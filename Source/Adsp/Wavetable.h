@@ -0,0 +1,216 @@
+/*
+ * Wavetable.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_ADSP_WAVETABLE_H_
+#define SOURCE_ADSP_WAVETABLE_H_
+
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "Interpolation.h"
+
+namespace Adsp {
+/**
+ * @defgroup wavetable
+ * @ingroup Adsp
+ * Band limited versions of the waveforms in Waveform.h, for
+ * oscillators that would otherwise alias. Each waveform is
+ * rendered once into a table per octave (a mip level), with
+ * every harmonic that would go over the nyquist frequency in
+ * that octave removed. Playing a waveform back is then just
+ * a table lookup.
+ * @{
+ */
+
+/**
+ * One cycle of a waveform, band limited at MIP_LEVELS
+ * different pitches.
+ */
+class Wavetable {
+public:
+	static constexpr int TABLE_SIZE = 2048, ///< Samples in one cycle of each mip level.
+			MIP_LEVELS = 11, ///< Level l has at most (TABLE_SIZE / 2) >> l harmonics, so the last level is a sine wave.
+			OVERSAMPLING = 8; ///< How many times more samples the waveform is rendered with before it is band limited.
+private:
+	std::vector<double> m_samples; ///< Each level, one after another. Every level has an extra copy of its first sample at the end, to make interpolating simpler.
+public:
+	/**
+	 * Renders and band limits a waveform. This takes a few
+	 * milliseconds, so it should never be done on the audio
+	 * thread. Use WavetableCache instead.
+	 * @param waveform Which waveform to render, in the order they are declared in Waveform.h. (0 is sine, 7 is symmetrical tanh.)
+	 * @param variable The var parameter of the waveform, between -1 and 1.
+	 * @param center Where phase 0 is moved to, between -1 and 1. See BasicOscController.
+	 */
+	Wavetable(int waveform, double variable, double center);
+
+	/**
+	 * Picks the mip level that has as many harmonics as
+	 * possible without any of them going over the nyquist
+	 * frequency.
+	 * @param increment How many cycles the waveform goes through every sample. (Frequency / sample rate.)
+	 * @return The mip level to pass to lookup().
+	 */
+	static int getMipLevel(double increment) {
+		int exponent;
+		std::frexp(std::fabs(increment) * TABLE_SIZE, &exponent);
+		return (exponent < 0) ? 0 : (exponent >= MIP_LEVELS) ? MIP_LEVELS - 1 : exponent;
+	}
+	/**
+	 * Reads the waveform at a particular phase, linearly
+	 * interpolating between the two nearest samples.
+	 * @param level The mip level to read from. See getMipLevel().
+	 * @param phase Where in the cycle to read, between 0 and 2. (Phase 0 of the table is phase -1 of the waveform.)
+	 * @return The value of the waveform.
+	 */
+	double lookup(int level, double phase) const {
+		double position = phase * (TABLE_SIZE / 2);
+		int index = int(position);
+		double blend = position - index;
+		const double * samples = &m_samples[level * (TABLE_SIZE + 1) + (index & (TABLE_SIZE - 1))]; //The & catches phases that round up to 2.
+		return linearInterp(samples[0], samples[1], blend);
+	}
+};
+
+/**
+ * Stores wavetables so that every oscillator using the same
+ * waveform shares one copy. The var and center parameters
+ * are rounded to the nearest 1 / QUANTIZE_STEPS, so that
+ * slowly turning a knob does not create a new table every
+ * sample.
+ *
+ * Tables are only ever rendered by renderRequested(), which
+ * runs on a background thread. The audio thread asks for a
+ * table with acquire(), which never blocks or allocates: if
+ * the table is not rendered yet it is requested and nullptr
+ * is returned, see WavetableHandle. Once there are more than
+ * MAX_TABLES tables, the oldest ones that nothing has
+ * acquired are deleted, also on the background thread.
+ */
+class WavetableCache {
+public:
+	static constexpr int QUANTIZE_STEPS = 32,
+			VALUES = QUANTIZE_STEPS * 2 + 1, ///< How many values var and center can be rounded to.
+			WAVEFORMS = 8, ///< How many waveforms there are, see Wavetable::Wavetable().
+			NUM_KEYS = WAVEFORMS * VALUES * VALUES, ///< Every key is between 0 and NUM_KEYS - 1.
+			MAX_TABLES = 32;
+private:
+	struct Retired {
+		int m_key;
+		Wavetable * m_table;
+	};
+	std::unique_ptr<std::atomic<Wavetable *>[]> m_tables; ///< The rendered table for each key, or nullptr.
+	std::unique_ptr<std::atomic<int>[]> m_users; ///< How many times the table for each key is acquired.
+	std::unique_ptr<std::atomic<bool>[]> m_requested; ///< Which keys renderRequested() should render.
+	std::atomic<bool> m_anyRequested; ///< Set whenever something in m_requested is, so renderRequested() does not have to look through all of them.
+	std::deque<int> m_rendered; ///< Keys of rendered tables, oldest first. Only used by renderRequested().
+	std::vector<Retired> m_retired; ///< Tables that were removed while something was acquiring them. Only used by renderRequested().
+	static WavetableCache * s_instance;
+	WavetableCache();
+	void evict();
+public:
+	static WavetableCache * getInstance();
+	~WavetableCache();
+
+	/**
+	 * Rounds the parameters of a waveform, and combines them
+	 * into a single number that identifies its table.
+	 * Waveforms that have no var parameter ignore it.
+	 * @param waveform Which waveform, see Wavetable::Wavetable().
+	 * @param variable The var parameter of the waveform.
+	 * @param center Where phase 0 is moved to.
+	 * @return A key to pass to getTable().
+	 */
+	static int getKey(int waveform, double variable, double center);
+	/**
+	 * Gets the table for a key, and stops it from being
+	 * deleted until release() is called. If the table has
+	 * not been rendered yet, it is requested instead. Safe
+	 * to call from the audio thread.
+	 * @param key A key from getKey().
+	 * @return The table, or nullptr if it is not rendered yet.
+	 */
+	const Wavetable * acquire(int key);
+	/**
+	 * Lets a table from acquire() be deleted again.
+	 * @param key The key the table was acquired with.
+	 */
+	void release(int key) {
+		m_users[key].fetch_sub(1);
+	}
+	/**
+	 * Asks for a table to be rendered the next time
+	 * renderRequested() is called, if it is not already.
+	 * Safe to call from any thread.
+	 * @param key A key from getKey().
+	 */
+	void request(int key) {
+		if (!m_requested[key].load(std::memory_order_relaxed)) {
+			m_requested[key].store(true);
+			m_anyRequested.store(true);
+		}
+	}
+	/**
+	 * Renders one requested table, and deletes old tables if
+	 * there are too many. Must only be called from one
+	 * thread, which should not be the audio thread.
+	 * @return false if nothing was requested.
+	 */
+	bool renderRequested();
+};
+
+/**
+ * Keeps hold of the table an oscillator is playing. When
+ * the oscillator moves to a different key, the old table
+ * keeps being used until the new one has been rendered in
+ * the background, so the audio thread never has to wait
+ * for a table. This should only be used from the audio
+ * thread.
+ */
+class WavetableHandle {
+private:
+	const Wavetable * m_table = nullptr;
+	int m_key = -1; ///< The key of m_table.
+public:
+	WavetableHandle() {
+	}
+	WavetableHandle(const WavetableHandle & other) = delete;
+	WavetableHandle & operator=(const WavetableHandle & other) = delete;
+	~WavetableHandle() {
+		if (m_table != nullptr) {
+			WavetableCache::getInstance()->release(m_key);
+		}
+	}
+
+	/**
+	 * Switches to the table for a key, if it is rendered.
+	 * @param key A key from WavetableCache::getKey().
+	 * @return The table for the key, or the previous table if it is not rendered yet. nullptr if there is no table at all yet.
+	 */
+	const Wavetable * update(int key) {
+		if (key != m_key) {
+			WavetableCache * cache = WavetableCache::getInstance();
+			const Wavetable * table = cache->acquire(key);
+			if (table != nullptr) {
+				if (m_table != nullptr) {
+					cache->release(m_key);
+				}
+				m_table = table;
+				m_key = key;
+			}
+		}
+		return m_table;
+	}
+};
+
+/** @} */
+
+} /* namespace Adsp */
+
+#endif /* SOURCE_ADSP_WAVETABLE_H_ */
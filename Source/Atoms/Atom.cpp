@@ -10,6 +10,7 @@
 #include <array>
 #include <iostream>
 
+#include "Adsp/Lanes.h"
 #include "Technical/SaveState.h"
 #include "Technical/Synth.h"
 
@@ -153,19 +154,48 @@ void AtomController::execute() {
 			Synth::getInstance()->getLogManager().endLabel();
 	}
 
+	//Batches don't log each voice separately, so they are skipped while debugging.
+	bool batch = supportsBatching() && !Synth::getInstance()->getLogManager().shouldDebugEverything();
+	Atom * lanes[Adsp::MAX_LANES];
+	int count = 0;
 	for (int i = 0; i < Synth::getInstance()->getParameters().m_polyphony; i++) {
 		if (Synth::getInstance()->getNoteManager().isActive(i)) { //Only bother calculating active notes
-			m_atoms[i]->executeWrapper();
+			if (!batch) {
+				m_atoms[i]->executeWrapper();
+			} else {
+				m_atoms[i]->beginExecution();
+				if (m_atoms[i]->prepareBatchLane(count)) {
+					lanes[count] = m_atoms[i];
+					count++;
+					if (count == Adsp::MAX_LANES) {
+						executeBatchWrapper(lanes, count);
+						count = 0;
+					}
+				} else {
+					m_atoms[i]->execute();
+					m_atoms[i]->endExecution();
+				}
+			}
 		} else if (Synth::getInstance()->getNoteManager().isStopped(i)) {
 			m_atoms[i]->reset();
 		}
 	}
+	if (count > 0) {
+		executeBatchWrapper(lanes, count);
+	}
 
 	if(Synth::getInstance()->getLogManager().shouldDebugEverything()) {
 		Synth::getInstance()->getLogManager().endLabel();
 	}
 }
 
+void AtomController::executeBatchWrapper(Atom ** atoms, int lanes) {
+	executeBatch(atoms, lanes);
+	for (int i = 0; i < lanes; i++) {
+		atoms[i]->endExecution();
+	}
+}
+
 void AtomController::stopControlAnimation() {
 	m_automation.stopAutomationAnimation();
 }
@@ -200,11 +230,11 @@ DVecIter* IOSet::addInput(AudioBuffer* input) {
 		return nullptr;
 	} else {
 		if (input->isConstant()) { //begin returns a temporary value.
-			m_constInputs.push_back(new DVecIter(input->getData().begin()));
+			m_constInputs.push_back(new DVecIter(input->getReadData()));
 			m_constInputSources.push_back(input);
 			return m_constInputs.back();
 		} else {
-			m_incInputs.push_back(new DVecIter(input->getData().begin()));
+			m_incInputs.push_back(new DVecIter(input->getReadData()));
 			m_incInputSources.push_back(input);
 			return m_incInputs.back();
 		}
@@ -213,17 +243,17 @@ DVecIter* IOSet::addInput(AudioBuffer* input) {
 
 DVecIter& IOSet::addOutput(AudioBuffer& output) {
 	m_outputSources.push_back(&output);
-	m_outputs.push_back(new DVecIter(output.getData().begin()));
+	m_outputs.push_back(new DVecIter(output.getData()));
 	return *m_outputs.back();
 }
 
 void IOSet::resetPosition() {
 	for (int i = 0; i < m_incInputSources.size(); i++)
-		(*m_incInputs[i]) = DVecIter(m_incInputSources[i]->getData().begin());
+		(*m_incInputs[i]) = DVecIter(m_incInputSources[i]->getReadData());
 	for (int i = 0; i < m_constInputSources.size(); i++)
-		(*m_constInputs[i]) = DVecIter(m_constInputSources[i]->getData().begin());
+		(*m_constInputs[i]) = DVecIter(m_constInputSources[i]->getReadData());
 	for (int i = 0; i < m_outputs.size(); i++)
-		(*m_outputs[i]) = DVecIter(m_outputSources[i]->getData().begin());
+		(*m_outputs[i]) = DVecIter(m_outputSources[i]->getData());
 }
 
 void IOSet::incrementPosition() {
@@ -255,10 +285,22 @@ Atom::~Atom() {
 }
 
 void Atom::executeWrapper() {
+	beginExecution();
+	execute();
+	endExecution();
+}
+
+void Atom::beginExecution() {
 	if(Synth::getInstance()->getLogManager().shouldDebugEverything()) {
 		Synth::getInstance()->getLogManager().addLabel("Voice " + std::to_string(m_parameters.m_id));
 	}
 
+	//Outputs are recalculated (or aliased again) every time.
+	for (AudioBuffer & output : m_outputs) {
+		output.unalias();
+		output.setLinked(false);
+	}
+
 	m_sampleRate = Synth::getInstance()->getParameters().m_sampleRate;
 	m_sampleRate_f = double(m_sampleRate);
 	if (m_parameters.m_id == 0) {
@@ -274,9 +316,9 @@ void Atom::executeWrapper() {
 	if (m_parameters.m_automationEnabled) {
 		m_p.m_automation.calculateAutomation(*this);
 	}
+}
 
-	execute();
-
+void Atom::endExecution() {
 	if(Synth::getInstance()->getLogManager().shouldDebugEverything()) {
 		for(int i = 0; i < m_outputs.size(); i++) {
 			Synth::getInstance()->getLogManager().addLabel("Output " + std::to_string(i));
@@ -291,6 +333,14 @@ void Atom::execute() {
 
 }
 
+bool Atom::inputsAreLinked() {
+	for (AudioBuffer * input : m_primaryInputs) {
+		if ((input != nullptr) && !input->isLinked())
+			return false;
+	}
+	return !m_parameters.m_automationEnabled || m_p.m_automation.isLinked();
+}
+
 void Atom::reset() {
 	m_shouldUpdateParent = getIndex() == 0;
 	if (m_shouldUpdateParent)
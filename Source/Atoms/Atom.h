@@ -19,7 +19,7 @@
 
 #define ATOM_TIME ((double(sample) / m_sampleRate_f) + m_time)
 //These are helper macros to create various controls and a corresponding iterator automatically.
-#define CONTROL(NAME, INAME, TYPE) TYPE m_##NAME; std::vector<double>::iterator m_##INAME
+#define CONTROL(NAME, INAME, TYPE) TYPE m_##NAME; double * m_##INAME
 #define KNOB(NAME) CONTROL(NAME##Knob, NAME##Iter, AtomKnob)
 #define CKNOB(NAME) CONTROL(NAME##Knob, NAME##Iter, CentsKnob)
 #define SKNOB(NAME) CONTROL(NAME##Knob, NAME##Iter, SemitonesKnob)
@@ -38,7 +38,7 @@ class AtomController;
 class AtomKnob;
 class SaveState;
 
-typedef std::vector<double>::iterator DVecIter;
+typedef double * DVecIter;
 
 /**
  * Stores parameters of an atom.
@@ -94,6 +94,12 @@ private:
 	AtomParameters m_parameters;
 	int m_x, m_y;
 	bool m_stopped, m_shouldBeDeleted;
+
+	/**
+	 * Calls executeBatch(), then endExecution() on every
+	 * atom in the batch.
+	 */
+	void executeBatchWrapper(Atom ** atoms, int lanes);
 protected:
 	AtomGui m_gui; ///< The gui that will be shown when this AtomController is clicked on. Add knobs and stuff like that to this.
 	AutomationSet m_automation; ///< Holds all automated controls for easy management.
@@ -337,6 +343,51 @@ public:
 	 * Calls Atom::execute() on all child Atom objects.
 	 */
 	virtual void execute();
+	/**
+	 * Returns true if this controller's atoms implement
+	 * Atom::executeFused(). AtomManager uses this to merge
+	 * chains of such controllers into a single pass over
+	 * the audio, instead of each one making its own pass
+	 * and writing its own output buffer.
+	 * @return True if Atom::executeFused() is implemented. (Default: false)
+	 */
+	virtual bool supportsFusion() {
+		return false;
+	}
+	/**
+	 * If this controller's atoms can make an output an
+	 * alias of one of their primary inputs (see
+	 * AudioBuffer::alias()), this should return the index
+	 * of that input. AtomManager uses this to keep the
+	 * input's memory from being reused while the output
+	 * is still being read.
+	 * @param output The index of the output.
+	 * @return The index of the primary input that output may be an alias of, or -1. (Default: -1)
+	 */
+	virtual int getPassthroughInput(int output) {
+		return -1;
+	}
+	/**
+	 * Returns true if this controller implements
+	 * executeBatch() and its atoms implement
+	 * Atom::prepareBatchLane(). execute() then renders up
+	 * to Adsp::MAX_LANES voices at once, one voice per
+	 * SIMD lane, instead of one voice after another.
+	 * @return True if executeBatch() is implemented. (Default: false)
+	 */
+	virtual bool supportsBatching() {
+		return false;
+	}
+	/**
+	 * Renders several voices at once. beginExecution() and
+	 * Atom::prepareBatchLane() have already been called on
+	 * each atom, in the order they are given, and
+	 * endExecution() is called on each of them afterwards.
+	 * @param atoms The atoms to render. atoms[i] was prepared as lane i.
+	 * @param lanes How many atoms there are, at most Adsp::MAX_LANES.
+	 */
+	virtual void executeBatch(Atom ** atoms, int lanes) {
+	}
 	/**
 	 * Calls AutomatedControl::clearDisplayValue() for all AutomatedControl
 	 * objects added via addAutomatedControl().
@@ -359,6 +410,14 @@ public:
 	AtomGui & getGui() {
 		return m_gui;
 	}
+	/**
+	 * Returns a reference to the set of automated
+	 * controls added via addAutomatedControl().
+	 * @return A reference to this controller's AutomationSet.
+	 */
+	AutomationSet & getAutomation() {
+		return m_automation;
+	}
 	/**
 	 * Returns the x coordinate of the controller's position.
 	 * @return The x coordinate of the controller's position.
@@ -424,7 +483,7 @@ class IOSet {
 private:
 	std::vector<AudioBuffer*> m_constInputSources, m_incInputSources, m_outputSources;
 	std::vector<DVecIter*> m_constInputs, m_incInputs, m_outputs;
-	//typedef std::vector<double>::iterator DVecIter;
+	//typedef double * DVecIter;
 public:
 	/**
 	 * Constructor
@@ -564,6 +623,15 @@ public:
 	AudioBuffer * getOutput(int index) {
 		return &m_outputs[index];
 	}
+	/**
+	 * Gets a pointer to the audio buffer that a
+	 * primary input is linked to.
+	 * @param index Index of the primary input.
+	 * @return A pointer to the linked audio buffer. (Can be nullptr)
+	 */
+	AudioBuffer * getPrimaryInput(int index) {
+		return m_primaryInputs[index];
+	}
 	/**
 	 * Returns the polyphony index of this Atom.
 	 * @return The polyphony index of this Atom.
@@ -572,11 +640,44 @@ public:
 		return m_parameters.m_id;
 	}
 
+	/**
+	 * Returns true if this Atom is going to update the
+	 * GUI of its parent during this iteration.
+	 * @return The value of m_shouldUpdateParent.
+	 */
+	bool getShouldUpdateParent() {
+		return m_shouldUpdateParent;
+	}
+	/**
+	 * Returns true if every connected primary input
+	 * and every automated control has the same data
+	 * on all channels. (See AudioBuffer::isLinked().)
+	 * Atoms that treat every channel the same way
+	 * only need to calculate channel 0 when this is
+	 * true, and can then use
+	 * AudioBuffer::linkChannels() on their outputs.
+	 * @return True if all inputs are linked.
+	 */
+	bool inputsAreLinked();
+
 	/**
 	 * Calls execute(). Does some extra things before
-	 * and after it, too.
+	 * and after it, too. (See beginExecution() and
+	 * endExecution().)
 	 */
 	void executeWrapper();
+	/**
+	 * Does everything that needs to happen before
+	 * execute() or executeFused() is called, such as
+	 * updating the sample rate and calculating
+	 * automation.
+	 */
+	void beginExecution();
+	/**
+	 * Does everything that needs to happen after
+	 * execute() has been called.
+	 */
+	void endExecution();
 
 	/**
 	 * Called when the Atom's function should be executed.
@@ -588,6 +689,42 @@ public:
 	 * objects are updated automatically.)
 	 */
 	virtual void execute();
+	/**
+	 * Processes part of a buffer in place. Only called if
+	 * AtomController::supportsFusion() returns true. It
+	 * should do exactly what execute() does, except that
+	 * instead of reading from primary input 0 and writing
+	 * to output 0, it should read from and write to buffer,
+	 * and only samples start to end (exclusive) of each
+	 * channel should be touched. buffer is never constant.
+	 * If buffer is linked (see AudioBuffer::isLinked()),
+	 * only channel 0 needs to be processed, it is copied
+	 * to the other channels once the whole chain is done.
+	 * Automation results are indexed the same way as in
+	 * execute(). It is never called when m_shouldUpdateParent
+	 * is true, so it does not need to update the GUI.
+	 * @param buffer The buffer to process in place.
+	 * @param start The first sample of each channel to process.
+	 * @param end One past the last sample of each channel to process.
+	 */
+	virtual void executeFused(AudioBuffer & buffer, int start, int end) {
+	}
+	/**
+	 * Only called if AtomController::supportsBatching()
+	 * returns true, right after beginExecution(). The
+	 * results of automation are shared by all voices and
+	 * are overwritten by the next voice, so this should
+	 * copy whatever AtomController::executeBatch() needs
+	 * into the given lane. If this voice can't be part of
+	 * a batch right now (e.g. because its automation
+	 * changes during the buffer), return false and
+	 * execute() is called instead.
+	 * @param lane Which lane of the batch this atom would be.
+	 * @return True if the atom joined the batch. (Default: false)
+	 */
+	virtual bool prepareBatchLane(int lane) {
+		return false;
+	}
 	/**
 	 * Called when whatever note this Atom was playing has
 	 * stopped. Use this to reset internal variables to
@@ -88,15 +88,15 @@ void InputAtom::execute() {
 
 	unsigned long int base = Synth::getInstance()->getParameters().m_timestamp - state.timestamp;
 	double time, frequency = state.frequency;
-	for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
-		for (int s = 0; s < AudioBuffer::getDefaultSize(); s++) {
-			time = (double(s + base) / m_sampleRate_f) * multiplier;
-			(*hzOutput) = frequency;
-			(*timeOutput) = time;
-			io.incrementPosition();
-		}
-		io.incrementChannel();
+	//Both outputs are the same on every channel, so only calculate the first one.
+	for (int s = 0; s < AudioBuffer::getDefaultSize(); s++) {
+		time = (double(s + base) / m_sampleRate_f) * multiplier;
+		(*hzOutput) = frequency;
+		(*timeOutput) = time;
+		io.incrementPosition();
 	}
+	m_outputs[0].linkChannels();
+	m_outputs[1].linkChannels();
 	/* END USER-DEFINED EXECUTION CODE */
 }
 
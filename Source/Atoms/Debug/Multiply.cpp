@@ -13,7 +13,22 @@
 namespace AtomSynth {
 
 /* BEGIN MISC. USER-DEFINED CODE */
-
+void MultiplyAtom::executeFused(AudioBuffer & buffer, int start, int end) {
+	AudioBuffer & fac11 = m_parent.m_fac11.getResult(),
+			& fac01 = m_parent.m_fac01.getResult();
+	int fac11Step = fac11.isConstant() ? 0 : 1,
+			fac01Step = fac01.isConstant() ? 0 : 1;
+	int size = AudioBuffer::getDefaultSamples();
+	int channels = (buffer.isLinked()) ? 1 : AudioBuffer::getDefaultChannels();
+	for(int c = 0; c < channels; c++) {
+		double * data = &buffer.getData()[c * size];
+		double * fac11Data = &fac11.getReadData()[c * size],
+				* fac01Data = &fac01.getReadData()[c * size];
+		for(int s = start; s < end; s++) {
+			data[s] = data[s] * fac01Data[s * fac01Step] * fac11Data[s * fac11Step];
+		}
+	}
+}
 /* END MISC. USER-DEFINED CODE */
 
 MultiplyController::MultiplyController() :
@@ -110,7 +125,20 @@ void MultiplyAtom::execute() {
 	if(signalInput == nullptr) {
 		m_primaryInputs[0]->fill(0.0);
 	} else {
-		for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++)
+		//If both factors are always 1, the output is just the input.
+		if(m_parent.m_fac01.getResult().isConstant() && m_parent.m_fac11.getResult().isConstant()) {
+			bool unity = true;
+			for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+				unity = unity && (m_parent.m_fac01.getResult().getValue(c, 0) * m_parent.m_fac11.getResult().getValue(c, 0) == 1.0);
+			}
+			if(unity) {
+				m_outputs[0].alias(*m_primaryInputs[0]);
+				return;
+			}
+		}
+		bool linked = inputsAreLinked();
+		int channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+		for(int c = 0; c < channels; c++)
 		{
 			for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++)
 			{
@@ -122,6 +150,9 @@ void MultiplyAtom::execute() {
 			automation.incrementChannel();
 			io.incrementChannel();
 		}
+		if(linked) {
+			m_outputs[0].linkChannels();
+		}
 	}
 	/* END USER-DEFINED EXECUTION CODE */
 }
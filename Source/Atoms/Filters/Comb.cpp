@@ -7,13 +7,90 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
+#include <algorithm>
+#include <cmath>
 
+#include "Technical/Synth.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
 
 /* BEGIN MISC. USER-DEFINED CODE */
+double CombController::getMaxDelay() {
+	switch (m_delaySource.getSelectedLabel()) {
+	case 0: //Hz Knob
+		return (m_hertzRange.getSelectedLabel() > 1) ? 0.1 : 1.0; //The kHz ranges go down to 10Hz, the others to 1Hz.
+	case 1: //Time Knob
+		switch (m_timeRange.getSelectedLabel()) {
+		case 0: //1ms
+			return 0.001;
+		case 1: //10ms
+			return 0.01;
+		case 2: //100ms
+			return 0.1;
+		default: //1s
+			return 1.0;
+		}
+	default: //Hz Input, which can be any frequency.
+		return MAX_DELAY;
+	}
+}
 
+void CombController::reserveDelayLines() {
+	const SynthParameters & parameters = Synth::getInstance()->getParameters();
+	if(!parameters.m_prepared) {
+		return; //The sample rate is only a placeholder, the patch is loaded again once the real one is known.
+	}
+	int samples = int(std::ceil(getMaxDelay() * parameters.m_sampleRate)) + 2; //The same size CombAtom::execute() asks for.
+	m_delayLines.set(parameters.m_polyphony, samples);
+}
+
+bool CombAtom::computeDelays(int channel, double longestDelay) {
+	int size = AudioBuffer::getDefaultSize();
+	AudioBuffer * source;
+	double scale = 1.0;
+	bool isFrequency = true, detuned = false;
+	switch (m_parent.m_delaySource.getSelectedLabel()) {
+	case 0: //Hz Knob
+		source = &m_parent.m_delayHz.getResult();
+		if (m_parent.m_hertzRange.getSelectedLabel() > 1) { //Labels 2 + 3 are kHz.
+			scale = 1000.0;
+		}
+		break;
+	case 1: //Time Knob
+		source = &m_parent.m_delayTime.getResult();
+		isFrequency = false;
+		if (m_parent.m_timeRange.getSelectedLabel() < 3) { //Label 3 is s instead of ms.
+			scale = 0.001;
+		}
+		break;
+	default: //Hz Input
+		if (m_primaryInputs[1] == nullptr) {
+			m_delays[0] = std::max(Adsp::DelayLine::MIN_DELAY, std::min(0.1 * m_sampleRate_f, longestDelay)); //Fixed .1 second delay.
+			return true;
+		}
+		source = m_primaryInputs[1];
+		detuned = true;
+		break;
+	}
+
+	AudioBuffer & octaves = m_parent.m_octaves.getResult(), & semitones = m_parent.m_semitones.getResult();
+	int sourceStep = (source->isConstant()) ? 0 : 1, octavesStep = (octaves.isConstant()) ? 0 : 1, semitonesStep =
+			(semitones.isConstant()) ? 0 : 1;
+	bool constant = sourceStep == 0 && (!detuned || (octavesStep == 0 && semitonesStep == 0));
+	const double * sourceData = source->getReadData() + channel * size, * octavesData = octaves.getReadData() + channel * size,
+			* semitonesData = semitones.getReadData() + channel * size;
+	for (int s = 0; s < ((constant) ? 1 : size); s++) {
+		double value = sourceData[s * sourceStep] * scale;
+		if (detuned) {
+			value = OctavesKnob::detune(SemitonesKnob::detune(value, semitonesData[s * semitonesStep]), octavesData[s * octavesStep]);
+		}
+		double delay = (isFrequency) ? m_sampleRate_f / value : value * m_sampleRate_f;
+		//Anything longer would read samples that have already been overwritten. (This also catches infinite delays from 0Hz.)
+		m_delays[s] = std::max(Adsp::DelayLine::MIN_DELAY, std::min(delay, longestDelay));
+	}
+	return constant;
+}
 /* END MISC. USER-DEFINED CODE */
 
 CombController::CombController() :
@@ -137,7 +214,7 @@ CombController::CombController() :
 	m_plot.setBounds(CB(1.000000, 3.500000, 10.000000, 3.000000));
 
 	/* BEGIN USER-DEFINED CONSTRUCTION CODE */
-	multiButtonPressed(&m_delaySource); //Show / hide things based on the selected delay source.
+	multiButtonPressed(&m_delaySource); //Show / hide things based on the selected delay source. This also reserves the delay lines.
 	m_plot.setLines(0, 0);
 
 	m_delayTime.setDynamic();
@@ -189,7 +266,7 @@ void CombController::loadSaveState(SaveState state) {
 		m_octaves.loadSaveState(extraData.getNextState());
 		m_semitones.loadSaveState(extraData.getNextState());
 		/* BEGIN USER-DEFINED LOAD CODE */
-
+		reserveDelayLines();
 		/* END USER-DEFINED LOAD CODE */
 	}
 	else if(version == 2) {
@@ -261,6 +338,7 @@ void CombController::multiButtonPressed(MultiButton * button) {
 		m_delayTime.setSuffix((selected > 2) ? "s" : "ms"); //Label 3 is s instead of ms
 		m_delayTime.repaint();
 	}
+	reserveDelayLines(); //Every button changes how long the delay can be.
 	/* END USER-DEFINED LISTENER CODE */
 }
 
@@ -273,7 +351,9 @@ CombAtom::CombAtom(CombController & parent, int index) :
 		Atom(parent, index),
 		m_parent(parent) {
 	/* BEGIN USER-DEFINED CONSTRUCTION CODE */
-
+	//Sized here so execute() never allocates. The default size only changes in Synth::initialize(), which creates every atom again.
+	m_delays.resize(AudioBuffer::getDefaultSize());
+	m_written.resize(AudioBuffer::getDefaultSize());
 	/* END USER-DEFINED CONSTRUCTION CODE */
 }
 
@@ -294,95 +374,85 @@ void CombAtom::execute() {
 	DVecIter & signalOutput = io.addOutput(m_outputs[0]);
 
 	/* BEGIN USER-DEFINED EXECUTION CODE */
-	int offset = m_delayLine.getSize() - AudioBuffer::getDefaultSamples();
-
-	double delay = 0.0, value, detune = 1.0;
-	int delayRange, delaySource = m_parent.m_delaySource.getSelectedLabel();
-	bool delaySourceConstant, detuneConstant;
-	if(delaySource == 0) { //Hz Knob
-		delaySourceConstant = m_parent.m_delayHz.getResult().isConstant();
-		delayRange = m_parent.m_hertzRange.getSelectedLabel();
-	} else if(delaySource == 1) { //Time Knob
-		delaySourceConstant = m_parent.m_delayTime.getResult().isConstant();
-		delayRange = m_parent.m_timeRange.getSelectedLabel();
-	} else if(delaySource == 2) { //Hz input
-		if(m_primaryInputs[0] == nullptr) {
-			delay = 0.1; //Fixed .1 second delay.
-			delaySource = 10; //There is no -1, so no recalculation will be done.
-		} else {
-			delaySourceConstant = m_primaryInputs[0]->isConstant();
-			detuneConstant = m_parent.m_octaves.getResult().isConstant() && m_parent.m_semitones.getResult().isConstant();
-		}
+	//The delay line only has to be long enough for the longest delay the controls allow, at the current sample rate.
+	int size = AudioBuffer::getDefaultSize();
+	double maxDelay = m_parent.getMaxDelay();
+	int delaySamples = int(std::ceil(maxDelay * m_sampleRate_f)) + 2; //+2 for the samples the interpolation reads on either side.
+	if (!m_delayLine || m_delayLine->getMaxDelay() < delaySamples - 2) {
+		m_delayLine = m_parent.m_delayLines.take(delaySamples); //Gives the old one back.
 	}
 
-	for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
-		if(detuneConstant) {
-			detune = OctavesKnob::detune(SemitonesKnob::detune(1.0, *semitonesIter), *octavesIter);
-		}
-		if(delaySourceConstant) {
-			if(delaySource == 0) { //Hz Knob
-				delay = 1.0 / *delayHzIter;
-				if(delayRange > 2) { //3 is kHz instead of Hz
-					delay /= 1000.0;
-				}
-			} else if(delaySource == 1) { //Time Knob
-				delay = *delayTimeIter;
-				if(delayRange < 3) { //3 is s instead of ms
-					delay /= 1000.0;
-				}
-			} else if(delaySource == 2) { //Hz input
-				delay = 1.0 / **freqInput;
+	//Constant buffers only store their value at the start of each channel, so they are read with a step of 0.
+	static const double SILENCE = 0.0;
+	AudioBuffer & feedback = m_parent.m_feedback.getResult(), & dryMix = m_parent.m_dryMix.getResult();
+	int feedbackStep = (feedback.isConstant()) ? 0 : 1, dryMixStep = (dryMix.isConstant()) ? 0 : 1;
+	int inputStep = (m_primaryInputs[0] == nullptr || m_primaryInputs[0]->isConstant()) ? 0 : 1;
+	if (!m_delayLine) {
+		//The pool has no free line yet, because more voices started at once than it keeps spare lines for or it is full.
+		//Only the dry signal is played until it has one, which is tried again every block.
+		for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+			const double * dryMixData = dryMix.getReadData() + c * size;
+			const double * input = (m_primaryInputs[0] == nullptr) ? &SILENCE : m_primaryInputs[0]->getReadData() + c * size;
+			double * output = m_outputs[0].getData() + c * size;
+			for (int s = 0; s < size; s++) {
+				output[s] = input[s * inputStep] * dryMixData[s * dryMixStep];
 			}
 		}
-		for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++) {
-			if(!delaySourceConstant || m_shouldUpdateParent) {
-				if(delaySource == 0) { //Hz Knob
-					delay = 1.0 / *delayHzIter;
-					if(delayRange > 2) { //3 is kHz instead of Hz
-						delay /= 1000.0;
-					}
-				} else if(delaySource == 1) { //Time Knob
-					delay = *delayTimeIter;
-					if(delayRange < 3) { //3 is s instead of ms
-						delay /= 1000.0;
-					}
-				} else if(delaySource == 2) { //Hz input
-					if(detuneConstant) {
-						delay = 1.0 / (**freqInput * detune);
-					} else {
-						delay = 1.0 / (**freqInput * OctavesKnob::detune(SemitonesKnob::detune(1.0, *semitonesIter), *octavesIter));
-					}
+		m_outputs[0].setConstant(false);
+		return;
+	}
+	Adsp::DelayLine & delayLine = *m_delayLine;
+	double longestDelay = std::min(maxDelay * m_sampleRate_f, delayLine.getMaxDelay());
+	for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+		bool delayConstant = computeDelays(c, longestDelay);
+		const double * feedbackData = feedback.getReadData() + c * size, * dryMixData = dryMix.getReadData() + c * size;
+		const double * input = (m_primaryInputs[0] == nullptr) ? &SILENCE : m_primaryInputs[0]->getReadData() + c * size;
+		double * output = m_outputs[0].getData() + c * size;
+		if (delayConstant) {
+			//With a fixed delay, everything read in a chunk was written before it, so whole chunks can be read and written at once.
+			double delay = m_delays[0];
+			int chunk = Adsp::DelayLine::getMaxBlock(delay);
+			for (int start = 0; start < size; start += chunk) {
+				int samples = std::min(chunk, size - start);
+				double * delayed = output + start;
+				delayLine.readBlock(c, start, delay, Adsp::DelayInterpolation::CUBIC, delayed, samples);
+				//The delayed samples were read straight into the output, so the dry signal just has to be added to them.
+				for (int s = 0; s < samples; s++) {
+					int i = start + s;
+					m_written[s] = input[i * inputStep] + delayed[s] * feedbackData[i * feedbackStep];
+					delayed[s] += input[i * inputStep] * dryMixData[i * dryMixStep];
 				}
+				delayLine.writeBlock(c, start, m_written.data(), samples);
 			}
-
-			value = m_delayLine.get(c, offset + s - delay * m_sampleRate_f);
-			if(signalInput == nullptr) {
-				m_delayLine.set(c, offset + s, value * *feedbackIter);
-			} else {
-				m_delayLine.set(c, offset + s, **signalInput + value * *feedbackIter);
-			}
-			if(signalInput == nullptr) {
-				*signalOutput = value;
-			} else {
-				*signalOutput = value + **signalInput * *dryMixIter;
+		} else {
+			for (int s = 0; s < size; s++) {
+				double delayed = delayLine.read(c, s, m_delays[s], Adsp::DelayInterpolation::CUBIC);
+				delayLine.write(c, s, input[s * inputStep] + delayed * feedbackData[s * feedbackStep]);
+				output[s] = delayed + input[s * inputStep] * dryMixData[s * dryMixStep];
 			}
-			automation.incrementPosition();
-			io.incrementPosition();
 		}
-		automation.incrementChannel();
-		io.incrementChannel();
 	}
-	if(m_shouldUpdateParent) {
-		m_parent.m_plot.drawDataFromAudioBuffer(m_delayLine, m_delayLine.getSize() - delay * m_sampleRate_f);
+	delayLine.advance(size);
+	m_outputs[0].setConstant(false);
+
+	if (m_shouldUpdateParent) {
+		//Show everything from the longest delay in the block up to now.
+		double delay = m_delays[size - 1];
+		WaveformPlot & plot = m_parent.m_plot;
+		plot.clear();
+		for (int x = 0; x < plot.getWidth(); x++) {
+			double position = std::max(Adsp::DelayLine::MIN_DELAY, delay * (1.0 - double(x) / plot.getWidth()));
+			plot.addPoint(delayLine.read(0, 0, position, Adsp::DelayInterpolation::CUBIC));
+		}
+		plot.finish();
 	}
-	m_delayLine.offsetData(-AudioBuffer::getDefaultSamples());
 	/* END USER-DEFINED EXECUTION CODE */
 }
 
 void CombAtom::reset() {
 	Atom::reset();
 	/* BEGIN USER-DEFINED RESET CODE */
-	m_delayLine.fill(0.0);
+	DelayLinePool::getInstance()->giveBack(m_delayLine); //The voice is silent until its next note, so another voice can use the memory.
 	m_parent.m_plot.clear();
 	/* END USER-DEFINED RESET CODE */
 }
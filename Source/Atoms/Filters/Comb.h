@@ -6,7 +6,7 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
-
+#include "Technical/DelayLinePool.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
@@ -50,7 +50,7 @@ private:
 	/* END AUTO-GENERATED MEMBERS */
 
 	/* BEGIN USER-DEFINED MEMBERS */
-
+	DelayLinePool::Reservation m_delayLines; ///< Delay lines for the voices that are playing, see reserveDelayLines().
 	/* END USER-DEFINED MEMBERS */
 public:
 	/* BEGIN AUTO-GENERATED METHODS */
@@ -80,7 +80,22 @@ public:
 	/* END AUTO-GENERATED LISTENERS */
 
 	/* BEGIN USER-DEFINED METHODS */
-
+	static constexpr double MAX_DELAY = 1.0; ///< The longest delay any setting can reach, in seconds.
+	/**
+	 * Gets the longest delay that the current delay source
+	 * and range can reach, so that delay lines can be sized
+	 * to fit it.
+	 * @return The longest delay, in seconds.
+	 */
+	double getMaxDelay();
+	/**
+	 * Tells DelayLinePool how long the delay lines have to
+	 * be for getMaxDelay(), and that every voice can need
+	 * one. The pool allocates them as voices start playing,
+	 * so CombAtom never has to allocate one on the audio
+	 * thread.
+	 */
+	void reserveDelayLines();
 	/* END USER-DEFINED METHODS */
 
 	friend class CombAtom;
@@ -96,7 +111,8 @@ private:
 	/* END AUTO-GENERATED MEMBERS */
 
 	/* BEGIN USER-DEFINED MEMBERS */
-	LoopedAudioBuffer m_delayLine = LoopedAudioBuffer(45000);
+	DelayLinePool::DelayLine m_delayLine; ///< Taken from CombController::m_delayLines while the voice is playing.
+	std::vector<double> m_delays, m_written; ///< The delay of each sample in the current block, and the samples being written back to the delay line.
 	/* END USER-DEFINED MEMBERS */
 public:
 	/* BEGIN AUTO-GENERATED METHODS */
@@ -109,7 +125,14 @@ public:
 	/* END AUTO-GENERATED METHODS */
 
 	/* BEGIN USER-DEFINED METHODS */
-
+	/**
+	 * Works out the delay of every sample in one channel of
+	 * the current block, and puts them in m_delays.
+	 * @param channel The channel to work out.
+	 * @param longestDelay The longest delay the delay line can reach, in samples.
+	 * @return True if the delay is the same for the whole block, in which case only m_delays[0] is set.
+	 */
+	bool computeDelays(int channel, double longestDelay);
 	/* END USER-DEFINED METHODS */
 
 	friend class CombController;
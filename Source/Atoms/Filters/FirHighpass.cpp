@@ -7,13 +7,40 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
+#include "Technical/FirPrewarmer.h"
 #include "Technical/Synth.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
 
 /* BEGIN MISC. USER-DEFINED CODE */
+int FirHighpassController::getFilterType() {
+	static const int QUALITIES[] = { Adsp::FilterType::NORMAL_QUALITY, Adsp::FilterType::HIGH_QUALITY, Adsp::FilterType::FULL_QUALITY };
+	return FirHighpassAtom::FILTER_TYPE | QUALITIES[m_quality.getSelectedLabel()];
+}
 
+void FirHighpassController::prewarm() {
+	double minOcts, maxOcts, minSemis, maxSemis;
+	m_octs.getReachableRange(minOcts, maxOcts);
+	m_semis.getReachableRange(minSemis, maxSemis);
+	double sampleRate = Synth::getInstance()->getParameters().m_sampleRate;
+	if(m_cutoffSource.getSelectedLabel() == 0) {
+		//The Hz input could be anything, but it is usually the frequency of a note, so only those are prewarmed.
+		//If the detune is automated too, the cutoff could be almost anything, which is left to be computed when it is used.
+		std::vector<double> cutoffs;
+		if(minOcts == maxOcts && minSemis == maxSemis) {
+			for(int note = 0; note < 128; note++) {
+				double frequency = pow(2.0, (double(note) - 69.0) / 12.0) * 440.0;
+				cutoffs.push_back(SemitonesKnob::detune(OctavesKnob::detune(frequency, minOcts), minSemis));
+			}
+		}
+		FirPrewarmer::getInstance()->request(getFilterType(), sampleRate, cutoffs);
+	} else {
+		double lowest = SemitonesKnob::detune(OctavesKnob::detune(440.0, minOcts), minSemis);
+		double highest = SemitonesKnob::detune(OctavesKnob::detune(440.0, maxOcts), maxSemis);
+		FirPrewarmer::getInstance()->request(getFilterType(), sampleRate, lowest, highest);
+	}
+}
 /* END MISC. USER-DEFINED CODE */
 
 FirHighpassController::FirHighpassController() :
@@ -45,7 +72,15 @@ FirHighpassController::FirHighpassController() :
 	m_gui.addComponent(m_octs.createLabel("Octaves", true));
 
 	/* BEGIN USER-DEFINED CONSTRUCTION CODE */
-
+	m_gui.addComponent(&m_quality);
+	m_quality.setBounds(CB(1.5, 4.5, 2.0, 2.0));
+	m_quality.addListener(this);
+	m_quality.setVertical(true);
+	m_quality.addLabel("Normal");
+	m_quality.addLabel("High");
+	m_quality.addLabel("Full");
+	m_gui.addComponent(m_quality.createLabel("Quality", true));
+	prewarm(); //Also prepares the cache, which the atoms can't look anything up without.
 	/* END USER-DEFINED CONSTRUCTION CODE */
 
 	m_gui.setAtomController(this);
@@ -60,12 +95,12 @@ SaveState FirHighpassController::saveSaveState() {
 	toReturn.addState(AtomController::saveSaveState());
 
 	SaveState & extraData = *new SaveState();
-	extraData.addValue(1); //Store the revision this was saved with, to preserve backwards compatibility.
+	extraData.addValue(2); //Store the revision this was saved with, to preserve backwards compatibility.
 	extraData.addState(m_cutoffSource.saveSaveState());
 	extraData.addState(m_semis.saveSaveState());
 	extraData.addState(m_octs.saveSaveState());
 	/* BEGIN USER-DEFINED SAVE CODE */
-
+	extraData.addState(m_quality.saveSaveState());
 	/* END USER-DEFINED SAVE CODE */
 	toReturn.addState(extraData);
 	return toReturn;
@@ -76,12 +111,22 @@ void FirHighpassController::loadSaveState(SaveState state) {
 	SaveState & extraData = state.getNextState();
 	int version = extraData.getNextValue();
 	/* BEGIN LOAD CODE */
-	if(version == 1) {
+	if(version == 2) {
+		m_cutoffSource.loadSaveState(extraData.getNextState());
+		m_semis.loadSaveState(extraData.getNextState());
+		m_octs.loadSaveState(extraData.getNextState());
+		/* BEGIN USER-DEFINED LOAD CODE */
+		m_quality.loadSaveState(extraData.getNextState());
+		prewarm();
+		/* END USER-DEFINED LOAD CODE */
+	}
+	else if(version == 1) {
 		m_cutoffSource.loadSaveState(extraData.getNextState());
 		m_semis.loadSaveState(extraData.getNextState());
 		m_octs.loadSaveState(extraData.getNextState());//
 		/* BEGIN USER-DEFINED LOAD CODE */
-
+		m_quality.setSelectedLabel(2, false); //Full quality, which is what these patches were made with.
+		prewarm();
 		/* END USER-DEFINED LOAD CODE */
 	}
 	/* END LOAD CODE */
@@ -89,16 +134,21 @@ void FirHighpassController::loadSaveState(SaveState state) {
 
 void FirHighpassController::multiButtonPressed(MultiButton * button) {
 	/* BEGIN USER-DEFINED LISTENER CODE */
+	prewarm();
 	/* END USER-DEFINED LISTENER CODE */
 }
 
 void FirHighpassController::automatedControlChanged(AutomatedControl * control, bool byUser) {
 	/* BEGIN USER-DEFINED LISTENER CODE */
+	//Loading calls this once for each control, prewarm() is called once they are all loaded.
+	if(byUser) {
+		prewarm();
+	}
 	/* END USER-DEFINED LISTENER CODE */
 }
 
 void FirHighpassAtom::recalculate(double newFreq) {
-	m_filter.set(FILTER_TYPE, newFreq, Synth::getInstance()->getParameters().m_sampleRate);
+	m_filter.set(m_parent.getFilterType(), newFreq, Synth::getInstance()->getParameters().m_sampleRate);
 }
 
 FirHighpassAtom::FirHighpassAtom(FirHighpassController & parent, int index) :
@@ -130,7 +180,8 @@ void FirHighpassAtom::execute() {
 		if(cutoffSource == 0) {
 			//Hz input.
 			if(m_primaryInputs[1] == nullptr) {
-				m_outputs[0].copyData(*m_primaryInputs[0]);
+				//Nothing to filter, pass the signal through without copying it.
+				m_outputs[0].alias(*m_primaryInputs[0]);
 				return;
 			} else {
 				double freq = **cutoffInput;
@@ -147,9 +198,27 @@ void FirHighpassAtom::execute() {
 			animateCutoff = !(m_parent.m_octs.getResult().isConstant() && m_parent.m_semis.getResult().isConstant());
 		}
 		m_delayLine.copyData(*m_primaryInputs[0], Adsp::CachedFirFilter::SIZE);
-		for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
-			for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++) {
-				if(animateCutoff) {
+		//The filter looks at the whole delay line, so the channels only come out
+		//the same once the input has been linked for that long.
+		if(m_primaryInputs[0]->isLinked()) {
+			m_linkedSamples = std::min(m_linkedSamples + AudioBuffer::getDefaultSamples(), m_delayLine.getSize());
+		} else {
+			m_linkedSamples = 0;
+		}
+		bool linked = inputsAreLinked() && (m_linkedSamples == m_delayLine.getSize());
+		int channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+		if(!animateCutoff) {
+			//The cutoff is the same for the whole block, so it can be filtered with FFT convolution instead of a dot product for every sample.
+			m_filter.computeBlock(m_delayLine, m_outputs[0], channels);
+		} else {
+			//The cutoff is only looked up at the start of every run of m_filterControlRate samples, and
+			//when it changes, the run is crossfaded from the old coefficients to the new ones.
+			int controlRate = std::max(1, Synth::getInstance()->getParameters().m_filterControlRate);
+			for(int c = 0; c < channels; c++) {
+				const double * history = m_delayLine.getReadData() + c * m_delayLine.getSize();
+				double * output = m_outputs[0].getData() + c * AudioBuffer::getDefaultSamples();
+				for(int start = 0; start < AudioBuffer::getDefaultSamples(); start += controlRate) {
+					int length = std::min(controlRate, AudioBuffer::getDefaultSamples() - start);
 					if(cutoffSource == 0) {
 						//Hz input.
 						double freq = **cutoffInput;
@@ -162,16 +231,21 @@ void FirHighpassAtom::execute() {
 						freq = SemitonesKnob::detune(freq, *semisIter);
 						recalculate(freq);
 					}
-
+					m_filter.computeCrossfaded(c, history + start, output + start, length);
+					for(int s = 0; s < length; s++) {
+						automation.incrementPosition();
+						io.incrementPosition();
+					}
 				}
-				*signalOutput = m_filter.compute(m_delayLine, c, s);
-				automation.incrementPosition();
-				io.incrementPosition();
+				automation.incrementChannel();
+				io.incrementChannel();
 			}
-			automation.incrementChannel();
-			io.incrementChannel();
 		}
 		m_delayLine.offsetData(-AudioBuffer::getDefaultSamples());
+		if(linked) {
+			m_outputs[0].linkChannels();
+			m_filter.linkChannels(AudioBuffer::getDefaultChannels());
+		}
 	}
 	/* END USER-DEFINED EXECUTION CODE */
 }
@@ -179,7 +253,7 @@ void FirHighpassAtom::execute() {
 void FirHighpassAtom::reset() {
 	Atom::reset();
 	/* BEGIN USER-DEFINED RESET CODE */
-
+	m_linkedSamples = 0;
 	/* END USER-DEFINED RESET CODE */
 }
 
@@ -33,7 +33,8 @@ private:
 	/* END AUTO-GENERATED MEMBERS */
 
 	/* BEGIN USER-DEFINED MEMBERS */
-
+	MultiButton m_quality; ///< Which Adsp::FilterType quality to use. Patches from before this existed load as full quality, which is what they were made with.
+	void prewarm(); ///< Prepares the cache the atoms look their coefficients up in, and has FirPrewarmer compute the cutoffs the controls are likely to reach.
 	/* END USER-DEFINED MEMBERS */
 public:
 	/* BEGIN AUTO-GENERATED METHODS */
@@ -63,7 +64,15 @@ public:
 	/* END AUTO-GENERATED LISTENERS */
 
 	/* BEGIN USER-DEFINED METHODS */
-
+	virtual int getPassthroughInput(int output) {
+		return 0;
+	}
+	/**
+	 * Gets the filter type to use, which is
+	 * FirLowpassAtom::FILTER_TYPE with the selected quality.
+	 * @return A bitwise-or combination from Adsp::FilterType.
+	 */
+	int getFilterType();
 	/* END USER-DEFINED METHODS */
 
 	friend class FirLowpassAtom;
@@ -79,9 +88,10 @@ private:
 	/* END AUTO-GENERATED MEMBERS */
 
 	/* BEGIN USER-DEFINED MEMBERS */
-	static constexpr int FILTER_TYPE = Adsp::FilterType::BLACKMAN | Adsp::FilterType::LOWPASS;
+	static constexpr int FILTER_TYPE = Adsp::FilterType::BLACKMAN | Adsp::FilterType::LOWPASS; ///< The quality is added by FirLowpassController::getFilterType().
 	Adsp::CachedFirFilter m_filter;
 	AudioBuffer m_delayLine;
+	int m_linkedSamples = 0; ///< How many of the newest samples in m_delayLine are the same on every channel.
 
 	void recalculate(double newFreq);
 	/* END USER-DEFINED MEMBERS */
@@ -7,11 +7,14 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
+#include <algorithm>
 #include <cmath>
 
 #include "Adsp/Basic.h"
 #include "Adsp/Remap.h"
 #include "Adsp/Waveform.h"
+#include "Technical/Synth.h"
+#include "Technical/WavetableRenderer.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
@@ -81,6 +84,32 @@ void BasicOscController::updatePlot() {
 	//m_plot.repaint();
 }
 
+void BasicOscController::prewarm() {
+	if(!usesWavetables()) {
+		return;
+	}
+	double minVar, maxVar, minCenter, maxCenter;
+	m_var.getReachableRange(minVar, maxVar);
+	m_center.getReachableRange(minCenter, maxCenter);
+	int variables = int(std::lround((maxVar - minVar) * Adsp::WavetableCache::QUANTIZE_STEPS)) + 1;
+	int centers = int(std::lround((maxCenter - minCenter) * Adsp::WavetableCache::QUANTIZE_STEPS)) + 1;
+	if(variables * centers > Adsp::WavetableCache::MAX_TABLES) {
+		//Too many to keep all of them, only render the table the knobs are set to. The rest are rendered when they are played.
+		minVar = maxVar = m_var.getValue();
+		minCenter = maxCenter = m_center.getValue();
+	}
+	WavetableRenderer::getInstance()->request(m_waveSelect.getSelectedLabel(), minVar, maxVar, minCenter, maxCenter);
+}
+
+void BasicOscAtom::scrambleIfNewNote() {
+	NoteState note = Synth::getInstance()->getNoteManager().getNoteState(getIndex());
+	if (note.timestamp != m_noteTimestamp) {
+		m_noteTimestamp = note.timestamp;
+		m_random.seed(Adsp::CounterRandom::makeKey(getIndex(), std::uint32_t(note.noteNumber)));
+		scramblePhases();
+	}
+}
+
 double BasicOscAtom::getUnisonFactor(int voice, int totalVoices) {
 	if (totalVoices == 1)
 		return 0.0;
@@ -97,13 +126,112 @@ void BasicOscAtom::scramblePhases() {
 	} else {
 		//Randomize all phases.
 		for(std::vector<double> & vec : m_phases) {
-			double value = (double(rand()) / RAND_MAX) * 2.0;
+			double value = m_random.next() + 1.0;
 			for(double & phase : vec) {
 				phase = value; //Apply same value to multiple channels to avoid accidental stereo wideness.
 			}
 		}
 	}
 }
+
+void BasicOscController::executeBatch(Atom ** atoms, int lanes) {
+	double * outputs[Adsp::MAX_LANES];
+	int size = AudioBuffer::getDefaultSize();
+	for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+		for (int i = 0; i < lanes; i++) {
+			outputs[i] = atoms[i]->getOutput(0)->getData() + c * size;
+		}
+		Adsp::renderOscillatorLanes(m_lanes[c], m_waveSelect.getSelectedLabel(), outputs, lanes, size);
+		for (int i = 0; i < lanes; i++) {
+			((BasicOscAtom*) atoms[i])->m_phases[0][c] = m_lanes[c].m_phase[i];
+		}
+	}
+}
+
+bool BasicOscAtom::canUseLanes() {
+	return !m_parent.usesWavetables() && (m_parent.m_waveSelect.getSelectedLabel() <= Adsp::LaneWaveform::TRIANGLE) && m_parent.m_automation.isConstant()
+			&& ((m_primaryInputs[0] == nullptr) || m_primaryInputs[0]->holdsOneValue());
+}
+
+bool BasicOscAtom::fillLane(Adsp::OscillatorLanes & lanes, int lane, int voice, int voices, int channel, double hz) {
+	//Same math as execute().
+	double uFac = getUnisonFactor(voice, voices);
+	double detune = OctavesKnob::detune(1.0, *m_parent.m_octavesIter);
+	detune *= SemitonesKnob::detune(1.0, *m_parent.m_semisIter);
+	detune *= CentsKnob::detune(1.0, *m_parent.m_centsIter);
+	detune *= *m_parent.m_fmIter;
+	double increment = hz * detune * CentsKnob::detune(1.0, *m_parent.m_uCentsIter * uFac) / m_sampleRate;
+	if (!(std::fabs(increment) < 1000.0)) //The lanes can't wrap phases any faster than that. (Also catches NaNs.)
+		return false;
+	double pan = Adsp::clip(*m_parent.m_panIter + uFac * (*m_parent.m_uPanIter));
+	double amplitude = *m_parent.m_amplitudeIter * ((channel == 0) ? Adsp::panLeftAmplitude(pan) : Adsp::panRightAmplitude(pan));
+	amplitude /= (voices + 1.0) * 0.5;
+	if (voice % 2 == 1) {
+		amplitude = -amplitude;
+	}
+
+	lanes.m_phase[lane] = m_phases[voice][channel];
+	lanes.m_increment[lane] = increment;
+	lanes.m_offset[lane] = *m_parent.m_phaseIter * 2.0 + (*m_parent.m_uPhaseIter) * uFac + 10.0;
+	lanes.m_center[lane] = *m_parent.m_centerIter;
+	//Remapping -1 - 1 to bottom - top, then amplifying.
+	lanes.m_scale[lane] = (*m_parent.m_topIter - *m_parent.m_bottomIter) * 0.5 * amplitude;
+	lanes.m_bias[lane] = (*m_parent.m_topIter + *m_parent.m_bottomIter) * 0.5 * amplitude;
+	return true;
+}
+
+bool BasicOscAtom::prepareBatchLane(int lane) {
+	scrambleIfNewNote();
+	//Only the most common case is batched: no unison, and nothing that changes during the buffer.
+	if (m_shouldUpdateParent || m_parent.m_uVoices.getValue() != 1 || !canUseLanes())
+		return false;
+
+	AutomationSet & automation = m_parent.m_automation;
+	automation.resetPosition();
+	IOSet io = IOSet();
+	DVecIter * hzInput = io.addInput(m_primaryInputs[0]);
+	for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+		if (!fillLane(m_parent.m_lanes[c], lane, 0, 1, c, (hzInput != nullptr) ? **hzInput : 440.0))
+			return false;
+		automation.incrementChannel();
+		io.incrementChannel();
+	}
+	return true;
+}
+
+bool BasicOscAtom::renderUnisonLanes(int voices) {
+	if (!canUseLanes())
+		return false;
+
+	//Every lane is filled in before anything is rendered, in case one of them can't be.
+	AutomationSet & automation = m_parent.m_automation;
+	automation.resetPosition();
+	IOSet io = IOSet();
+	DVecIter * hzInput = io.addInput(m_primaryInputs[0]);
+	for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+		for (int voice = 0; voice < voices; voice++) {
+			Adsp::OscillatorLanes & lanes = m_parent.m_unisonLanes[c * UNISON_GROUPS + voice / Adsp::MAX_LANES];
+			if (!fillLane(lanes, voice % Adsp::MAX_LANES, voice, voices, c, (hzInput != nullptr) ? **hzInput : 440.0))
+				return false;
+		}
+		automation.incrementChannel();
+		io.incrementChannel();
+	}
+
+	int size = AudioBuffer::getDefaultSize(), waveform = m_parent.m_waveSelect.getSelectedLabel();
+	double * output = m_outputs[0].getData();
+	for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+		for (int first = 0; first < voices; first += Adsp::MAX_LANES) {
+			Adsp::OscillatorLanes & lanes = m_parent.m_unisonLanes[c * UNISON_GROUPS + first / Adsp::MAX_LANES];
+			int count = std::min(Adsp::MAX_LANES, voices - first);
+			Adsp::mixOscillatorLanes(lanes, waveform, output + c * size, count, size);
+			for (int i = 0; i < count; i++) {
+				m_phases[first + i][c] = lanes.m_phase[i];
+			}
+		}
+	}
+	return true;
+}
 /* END MISC. USER-DEFINED CODE */
 
 BasicOscController::BasicOscController() :
@@ -242,7 +370,15 @@ BasicOscController::BasicOscController() :
 	m_gui.addComponent(m_fm.createLabel("FM", true));
 
 	/* BEGIN USER-DEFINED CONSTRUCTION CODE */
-
+	m_gui.addComponent(&m_modeSelect);
+	m_modeSelect.setBounds(CB(8.0, 14.0, 2.0, 2.0));
+	m_modeSelect.setVertical();
+	m_modeSelect.addListener(this);
+	m_modeSelect.addLabel("Math");
+	m_modeSelect.addLabel("Table");
+	m_modeSelect.setSelectedLabel(0, false);
+	m_lanes.resize(AudioBuffer::getDefaultChannels());
+	m_unisonLanes.resize(AudioBuffer::getDefaultChannels() * BasicOscAtom::UNISON_GROUPS);
 	/* END USER-DEFINED CONSTRUCTION CODE */
 
 	m_gui.setAtomController(this);
@@ -257,7 +393,7 @@ SaveState BasicOscController::saveSaveState() {
 	toReturn.addState(AtomController::saveSaveState());
 
 	SaveState & extraData = *new SaveState();
-	extraData.addValue(2); //Store the revision this was saved with, to preserve backwards compatibility.
+	extraData.addValue(3); //Store the revision this was saved with, to preserve backwards compatibility.
 	extraData.addState(m_waveSelect.saveSaveState());
 	extraData.addState(m_top.saveSaveState());
 	extraData.addState(m_uVoices.saveSaveState());
@@ -275,6 +411,7 @@ SaveState BasicOscController::saveSaveState() {
 	extraData.addState(m_semis.saveSaveState());
 	extraData.addState(m_fm.saveSaveState());
 	/* BEGIN USER-DEFINED SAVE CODE */
+	extraData.addState(m_modeSelect.saveSaveState());
 
 	/* END USER-DEFINED SAVE CODE */
 	toReturn.addState(extraData);
@@ -286,7 +423,30 @@ void BasicOscController::loadSaveState(SaveState state) {
 	SaveState & extraData = state.getNextState();
 	int version = extraData.getNextValue();
 	/* BEGIN LOAD CODE */
-	if(version == 2) {
+	if(version == 3) {
+		m_waveSelect.loadSaveState(extraData.getNextState());
+		m_top.loadSaveState(extraData.getNextState());
+		m_uVoices.loadSaveState(extraData.getNextState());
+		m_bottom.loadSaveState(extraData.getNextState());
+		m_pan.loadSaveState(extraData.getNextState());
+		m_phase.loadSaveState(extraData.getNextState());
+		m_amplitude.loadSaveState(extraData.getNextState());
+		m_var.loadSaveState(extraData.getNextState());
+		m_center.loadSaveState(extraData.getNextState());
+		m_uPan.loadSaveState(extraData.getNextState());
+		m_uPhase.loadSaveState(extraData.getNextState());
+		m_octaves.loadSaveState(extraData.getNextState());
+		m_cents.loadSaveState(extraData.getNextState());
+		m_uCents.loadSaveState(extraData.getNextState());
+		m_semis.loadSaveState(extraData.getNextState());
+		m_fm.loadSaveState(extraData.getNextState());
+		/* BEGIN USER-DEFINED LOAD CODE */
+		m_modeSelect.loadSaveState(extraData.getNextState());
+		prewarm();
+
+		/* END USER-DEFINED LOAD CODE */
+	}
+	else if (version == 2) {
 		m_waveSelect.loadSaveState(extraData.getNextState());
 		m_top.loadSaveState(extraData.getNextState());
 		m_uVoices.loadSaveState(extraData.getNextState());
@@ -304,6 +464,7 @@ void BasicOscController::loadSaveState(SaveState state) {
 		m_semis.loadSaveState(extraData.getNextState());
 		m_fm.loadSaveState(extraData.getNextState());
 		/* BEGIN USER-DEFINED LOAD CODE */
+		m_modeSelect.setSelectedLabel(0, false); //Patches from before wavetable mode.
 
 		/* END USER-DEFINED LOAD CODE */
 	}
@@ -324,6 +485,7 @@ void BasicOscController::loadSaveState(SaveState state) {
 		m_uCents.loadSaveState(extraData.getNextState());
 		m_semis.loadSaveState(extraData.getNextState());
 		/* BEGIN USER-DEFINED LOAD CODE */
+		m_modeSelect.setSelectedLabel(0, false);
 
 		/* END USER-DEFINED LOAD CODE */
 	}
@@ -340,12 +502,17 @@ void BasicOscController::multiButtonPressed(MultiButton * button) {
 		}
 	}
 	updatePlot();
+	prewarm();
 	/* END USER-DEFINED LISTENER CODE */
 }
 
 void BasicOscController::automatedControlChanged(AutomatedControl * control, bool byUser) {
 	/* BEGIN USER-DEFINED LISTENER CODE */
 	updatePlot();
+	//Loading calls this once for each control, prewarm() is called once they are all loaded.
+	if(byUser) {
+		prewarm();
+	}
 	/* END USER-DEFINED LISTENER CODE */
 }
 
@@ -389,6 +556,7 @@ void BasicOscAtom::execute() {
 	DVecIter & audioOutput = io.addOutput(m_outputs[0]);
 
 	/* BEGIN USER-DEFINED EXECUTION CODE */
+	scrambleIfNewNote();
 	int voices = m_parent.m_uVoices.getValue();
 
 	double baseDetune;
@@ -401,140 +569,164 @@ void BasicOscAtom::execute() {
 	double pan;
 	bool animatePan = !m_parent.m_pan.getResult().isConstant();
 	m_outputs[0].fill(0.0);
-	double basePan, freq, panAmp, phase, uFac, uDetune, value;
-	for (int voice = 0; voice < voices; voice++) { //Iterate over each voice.
-		automation.resetPosition();
-		io.resetPosition();
-		for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
-			baseDetune = 1.0;
-			if (!animateCoarseDetune) {
-				baseDetune *= OctavesKnob::detune(1.0, (*octavesIter)); //Detuning 1 hz up 2 octaves = 2 hz. This is the same as getting the detune factor for the number of octaves. Used later.
-				baseDetune *= SemitonesKnob::detune(1.0, (*semisIter));
-			}
-			if (!animateCents) {
-				baseDetune *= CentsKnob::detune(1.0, (*centsIter));
-			}
-			if (!animateFm) {
-				baseDetune *= *fmIter;
-			}
-			if (hzInput != nullptr) {
-				baseFrequency = (**hzInput) * baseDetune;
-				if(m_primaryInputs[0]->isConstant()) {
-					baseFrequency = (**hzInput) * baseDetune;
-				} else {
-					animateBaseFreq = true;
+	double basePan, freq, panAmp, phase, uFac, uDetune, unwarped, value;
+	//Without automation that changes during the buffer, every unison voice can be rendered at once in SIMD lanes.
+	if (!renderUnisonLanes(voices)) {
+		int waveform = m_parent.m_waveSelect.getSelectedLabel();
+		bool useTables = m_parent.usesWavetables();
+		bool animateShape = !m_parent.m_var.getResult().isConstant() || !m_parent.m_center.getResult().isConstant();
+		const Adsp::Wavetable * table = nullptr;
+		for (int voice = 0; voice < voices; voice++) { //Iterate over each voice.
+			automation.resetPosition();
+			io.resetPosition();
+			uFac = getUnisonFactor(voice, voices);
+			for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+				baseDetune = 1.0;
+				if (!animateCoarseDetune) {
+					baseDetune *= OctavesKnob::detune(1.0, (*octavesIter)); //Detuning 1 hz up 2 octaves = 2 hz. This is the same as getting the detune factor for the number of octaves. Used later.
+					baseDetune *= SemitonesKnob::detune(1.0, (*semisIter));
 				}
-			} else {
-				baseFrequency = 440.0 * baseDetune;
-			}
-			if (!animatePan) {
-				if (voices > 1) {
-					pan = *panIter + (uFac * (*uPanIter));
+				if (!animateCents) {
+					baseDetune *= CentsKnob::detune(1.0, (*centsIter));
+				}
+				if (!animateFm) {
+					baseDetune *= *fmIter;
+				}
+				if (hzInput != nullptr) {
+					baseFrequency = (**hzInput) * baseDetune;
+					if(m_primaryInputs[0]->isConstant()) {
+						baseFrequency = (**hzInput) * baseDetune;
+					} else {
+						animateBaseFreq = true;
+					}
 				} else {
-					pan = *panIter;
+					baseFrequency = 440.0 * baseDetune;
 				}
-				pan = Adsp::clip(pan);
-				//Sinusoidal panning
-				if (c == 0) //left
-					panAmp = Adsp::panLeftAmplitude(pan);
-				else //right
-					panAmp = Adsp::panRightAmplitude(pan);
-			}
-			if (voices > 1) {
-				uDetune = CentsKnob::detune(1.0, (*uCentsIter) * getUnisonFactor(voice, voices));
-			}
-			for (int s = 0; s < AudioBuffer::getDefaultSize(); s++) {
-				uFac = getUnisonFactor(voice, voices);
-				if (animatePan) {
+				if (!animatePan) {
 					if (voices > 1) {
 						pan = *panIter + (uFac * (*uPanIter));
 					} else {
 						pan = *panIter;
 					}
+					pan = Adsp::clip(pan);
 					//Sinusoidal panning
 					if (c == 0) //left
 						panAmp = Adsp::panLeftAmplitude(pan);
 					else //right
 						panAmp = Adsp::panRightAmplitude(pan);
 				}
-
-				if(animateBaseFreq) {
-					freq = (**hzInput) * baseDetune;
-				} else {
-					freq = baseFrequency;
-				}
-
 				if (voices > 1) {
-					freq *= uDetune;
-				}
-
-				if (animateCoarseDetune) {
-					freq = OctavesKnob::detune(freq, (*octavesIter));
-					freq = SemitonesKnob::detune(freq, (*semisIter));
+					uDetune = CentsKnob::detune(1.0, (*uCentsIter) * getUnisonFactor(voice, voices));
 				}
-				if (animateCents) {
-					freq = CentsKnob::detune(freq, (*centsIter));
-				}
-				if(animateFm) {
-					freq *= *fmIter;
+				//Until the first table has been rendered in the background, the waveform is computed instead.
+				if (useTables && !animateShape) {
+					table = m_table.update(Adsp::WavetableCache::getKey(waveform, *varIter, *centerIter));
 				}
+				for (int s = 0; s < AudioBuffer::getDefaultSize(); s++) {
+					if (animatePan) {
+						if (voices > 1) {
+							pan = *panIter + (uFac * (*uPanIter));
+						} else {
+							pan = *panIter;
+						}
+						//Sinusoidal panning
+						if (c == 0) //left
+							panAmp = Adsp::panLeftAmplitude(pan);
+						else //right
+							panAmp = Adsp::panRightAmplitude(pan);
+					}
 
-				m_phases[voice][c] += freq / m_sampleRate;
-				m_phases[voice][c] = std::fmod(m_phases[voice][c] + 10.0, 2.0); //To avoid negative phases (when frequency is negative)
-				phase = m_phases[voice][c] + (*phaseIter) * 2.0 + ((*uPhaseIter) * uFac) + 10.0; //+10.0 is so that I don't have to do a branch in case the phase went into fmod being negative.
-				phase = std::fmod(phase, 2.0) - 1.0; //Output needs to be in range -1-1
+					if(animateBaseFreq) {
+						freq = (**hzInput) * baseDetune;
+					} else {
+						freq = baseFrequency;
+					}
 
-				if (phase <= *centerIter) {
-					phase = (phase + 1.0) / (*centerIter + 1.0 + 1.0e-64) - 1.0; //1.0e-64 is there to prevent divide by zero errors when * centerIter == -1.0
-				} else {
-					phase = (phase - *centerIter) / (1.0 - *centerIter);
-				}
+					if (voices > 1) {
+						freq *= uDetune;
+					}
 
-				switch (m_parent.m_waveSelect.getSelectedLabel()) {
-				case 0:
-					value = Adsp::sineWave(phase);
-					break;
-				case 1:
-					value = Adsp::squareWave(phase);
-					break;
-				case 2:
-					value = Adsp::triWave(phase);
-					break;
-				case 3:
-					value = Adsp::expWave(phase, *varIter);
-					break;
-				case 4:
-					value = Adsp::expSymmWave(phase, *varIter);
-					break;
-				case 5:
-					value = Adsp::expCrestWave(phase, *varIter);
-					break;
-				case 6:
-					value = Adsp::tanhWave(phase, *varIter);
-					break;
-				case 7:
-					value = Adsp::tanhSymmWave(phase, *varIter);
-					break;
-				default:
-					value = 0.2;
-				}
-				value = Adsp::remap(value, -1.0, 1.0, *bottomIter, *topIter);
-				value *= *amplitudeIter;
-				value *= panAmp;
-				value /= (voices + 1.0) * 0.5; //This way, many-voice synths don't sound super loud.
-				if (voice % 2 == 1) {
-					value = -value; //To prevent a buildup of constructive interference / dc offsets.
-				}
+					if (animateCoarseDetune) {
+						freq = OctavesKnob::detune(freq, (*octavesIter));
+						freq = SemitonesKnob::detune(freq, (*semisIter));
+					}
+					if (animateCents) {
+						freq = CentsKnob::detune(freq, (*centsIter));
+					}
+					if(animateFm) {
+						freq *= *fmIter;
+					}
+
+					m_phases[voice][c] += freq / m_sampleRate;
+					m_phases[voice][c] = std::fmod(m_phases[voice][c] + 10.0, 2.0); //To avoid negative phases (when frequency is negative)
+					phase = m_phases[voice][c] + (*phaseIter) * 2.0 + ((*uPhaseIter) * uFac) + 10.0; //+10.0 is so that I don't have to do a branch in case the phase went into fmod being negative.
+					phase = std::fmod(phase, 2.0);
+
+					//An automated shape only picks a new table every TABLE_KEY_INTERVAL samples.
+					if (useTables && animateShape && (s % TABLE_KEY_INTERVAL == 0)) {
+						table = m_table.update(Adsp::WavetableCache::getKey(waveform, *varIter, *centerIter));
+					}
+					if (table != nullptr) {
+						//The phase goes up by 2 every cycle, so that's freq / m_sampleRate / 2 cycles per sample.
+						value = table->lookup(Adsp::Wavetable::getMipLevel(freq / m_sampleRate * 0.5), phase);
+					} else {
+						phase -= 1.0; //Output needs to be in range -1-1
+						unwarped = phase; //Square and triangle waves need to know where their corners are before the center moves them.
+
+						if (phase <= *centerIter) {
+							phase = (phase + 1.0) / (*centerIter + 1.0 + 1.0e-64) - 1.0; //1.0e-64 is there to prevent divide by zero errors when * centerIter == -1.0
+						} else {
+							phase = (phase - *centerIter) / (1.0 - *centerIter);
+						}
+
+						switch (waveform) {
+						case 0:
+							value = Adsp::sineWave(phase);
+							break;
+						case 1:
+							value = Adsp::squareWaveBlep(unwarped, *centerIter, freq / m_sampleRate);
+							break;
+						case 2:
+							value = Adsp::triWaveBlamp(unwarped, *centerIter, freq / m_sampleRate);
+							break;
+						case 3:
+							value = Adsp::expWave(phase, *varIter);
+							break;
+						case 4:
+							value = Adsp::expSymmWave(phase, *varIter);
+							break;
+						case 5:
+							value = Adsp::expCrestWave(phase, *varIter);
+							break;
+						case 6:
+							value = Adsp::tanhWave(phase, *varIter);
+							break;
+						case 7:
+							value = Adsp::tanhSymmWave(phase, *varIter);
+							break;
+						default:
+							value = 0.2;
+						}
+					}
+					value = Adsp::remap(value, -1.0, 1.0, *bottomIter, *topIter);
+					value *= *amplitudeIter;
+					value *= panAmp;
+					value /= (voices + 1.0) * 0.5; //This way, many-voice synths don't sound super loud.
+					if (voice % 2 == 1) {
+						value = -value; //To prevent a buildup of constructive interference / dc offsets.
+					}
 
-				(*audioOutput) += value;
-				//if(animateCoarseDetune) m_outputs[0].getData()[s + (AudioBuffer::getDefaultSize() * c)] = freq / 800.0; //Debug
-				automation.incrementPosition();
-				io.incrementPosition();
+					(*audioOutput) += value;
+					//if(animateCoarseDetune) m_outputs[0].getData()[s + (AudioBuffer::getDefaultSize() * c)] = freq / 800.0; //Debug
+					automation.incrementPosition();
+					io.incrementPosition();
+				}
+				automation.incrementChannel();
+				io.incrementChannel();
 			}
-			automation.incrementChannel();
-			io.incrementChannel();
 		}
 	}
+	m_outputs[0].setLinked(false); //fill() links the channels, but panning makes them different.
 
 	if (m_shouldUpdateParent) {
 		m_parent.m_plot.setDataFromAudioBuffer(m_outputs[0]);
@@ -545,7 +737,7 @@ void BasicOscAtom::execute() {
 void BasicOscAtom::reset() {
 	Atom::reset();
 	/* BEGIN USER-DEFINED RESET CODE */
-	scramblePhases();
+
 	/* END USER-DEFINED RESET CODE */
 }
 
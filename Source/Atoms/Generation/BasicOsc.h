@@ -6,7 +6,9 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
-
+#include "Adsp/Lanes.h"
+#include "Adsp/Random.h"
+#include "Adsp/Wavetable.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
@@ -58,7 +60,9 @@ private:
 	/* END AUTO-GENERATED MEMBERS */
 
 	/* BEGIN USER-DEFINED MEMBERS */
-
+	MultiButton m_modeSelect; ///< Whether to compute waveforms with math (0) or play them from band limited wavetables (1).
+	std::vector<Adsp::OscillatorLanes> m_lanes; ///< One for each channel, filled in by BasicOscAtom::prepareBatchLane().
+	std::vector<Adsp::OscillatorLanes> m_unisonLanes; ///< BasicOscAtom::UNISON_GROUPS for each channel, used by BasicOscAtom::renderUnisonLanes().
 	/* END USER-DEFINED MEMBERS */
 public:
 	/* BEGIN AUTO-GENERATED METHODS */
@@ -91,6 +95,20 @@ public:
 
 	/* BEGIN USER-DEFINED METHODS */
 	void updatePlot();
+	void prewarm(); ///< Has WavetableRenderer render every table the controls can reach, so the audio thread does not have to.
+	/**
+	 * Checks if the oscillator is in wavetable mode, where
+	 * waveforms are read from Adsp::WavetableCache instead of
+	 * being computed every sample. Wavetables do not alias,
+	 * but var and center are rounded.
+	 */
+	bool usesWavetables() {
+		return m_modeSelect.getSelectedLabel() == 1;
+	}
+	virtual bool supportsBatching() {
+		return true;
+	}
+	virtual void executeBatch(Atom ** atoms, int lanes);
 	/* END USER-DEFINED METHODS */
 
 	friend class BasicOscAtom;
@@ -107,6 +125,9 @@ private:
 
 	/* BEGIN USER-DEFINED MEMBERS */
 	std::vector<std::vector<double>> m_phases;
+	Adsp::WavetableHandle m_table; ///< The table being played in wavetable mode.
+	Adsp::CounterRandom m_random; ///< Used by scramblePhases(), seeded from the voice and the note number at the start of each note.
+	unsigned long int m_noteTimestamp = -1; ///< When the note that the phases were last scrambled for started. Only used to notice new notes.
 	/* END USER-DEFINED MEMBERS */
 public:
 	/* BEGIN AUTO-GENERATED METHODS */
@@ -119,8 +140,40 @@ public:
 	/* END AUTO-GENERATED METHODS */
 
 	/* BEGIN USER-DEFINED METHODS */
+	static constexpr int UNISON_GROUPS = 2; ///< How many sets of lanes it takes to hold the most unison voices, 12.
+	static constexpr int TABLE_KEY_INTERVAL = 32; ///< How many samples in a row play the same wavetable when the shape is automated.
+
 	void scramblePhases();
+	/**
+	 * Scrambles the phases if a new note has started since
+	 * the last time this was called. The random numbers only
+	 * depend on the voice and the note number, so a note
+	 * starts with the same phases in every session and
+	 * every render.
+	 */
+	void scrambleIfNewNote();
 	static double getUnisonFactor(int voice, int totalVoices);
+	/**
+	 * Checks if this voice can be rendered with Adsp::OscillatorLanes
+	 * this time, which needs math mode, a waveform they support, constant
+	 * automation and a frequency input that holds one value for the whole
+	 * buffer. (See AudioBuffer::holdsOneValue(), since e.g. InputAtom does not
+	 * mark its frequency output as constant.)
+	 */
+	bool canUseLanes();
+	/**
+	 * Sets up one lane to render one unison voice. The automation
+	 * iterators must be on the right channel.
+	 * @return False if the voice is too high pitched to be rendered in a lane.
+	 */
+	bool fillLane(Adsp::OscillatorLanes & lanes, int lane, int voice, int voices, int channel, double hz);
+	/**
+	 * Renders every unison voice at once, using SIMD lanes,
+	 * adding them to output 0.
+	 * @return False if canUseLanes() is false, in which case nothing was rendered.
+	 */
+	bool renderUnisonLanes(int voices);
+	virtual bool prepareBatchLane(int lane);
 	/* END USER-DEFINED METHODS */
 
 	friend class BasicOscController;
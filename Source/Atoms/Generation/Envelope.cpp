@@ -9,6 +9,7 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
+#include <algorithm>
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
@@ -421,9 +422,7 @@ EnvelopeAtom::EnvelopeAtom(EnvelopeController & parent, int index) :
 		Atom(parent, index),
 		m_parent(parent) {
 	/* BEGIN USER-DEFINED CONSTRUCTION CODE */
-	m_releaseStart = 0.0;
-	m_releaseLevel.resize(AudioBuffer::getDefaultChannels(), 0.0);
-	m_releasing.resize(AudioBuffer::getDefaultChannels(), false);
+	m_envelopes.resize(AudioBuffer::getDefaultChannels());
 	/* END USER-DEFINED CONSTRUCTION CODE */
 }
 
@@ -455,53 +454,55 @@ void EnvelopeAtom::execute() {
 		double sustainTime = m_parent.m_sustainTime.getSeconds() * m_parent.m_sustainMult.getDisplayValue();
 		double releaseTime = m_parent.m_releaseTime.getSeconds() * m_parent.m_releaseMult.getDisplayValue();
 
-		double time = 0.0, ltime = 0.0;
-		bool triggerRelease = false;
-		for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
-			for (int s = 0; s < AudioBuffer::getDefaultSize(); s++) {
-				time = (**timeInput);
-				triggerRelease = (time < 0.0); //Negative time = key not being pressed, waiting for note to finish.
-				time = fabs(time);
-				if ((!triggerRelease) && m_releasing[c])
-					m_releasing[c] = false;
-				if (m_releasing[c]) {
-					if ((time - m_releaseStart) < releaseTime) {
-						ltime = time - m_releaseStart;
-						ltime /= releaseTime;
-						ltime = 1.0 - ltime; //go firom 0 - 1 to 1 - 0
-						(*envOutput) = Adsp::fastEnvelopeInterp(ltime, *releaseShapeIter) * m_releaseLevel[c] - 1.0;
-					} else {
-						(*envOutput) = -1.0;
-					}
+		int size = AudioBuffer::getDefaultSize();
+		AudioBuffer & input = *m_primaryInputs[0];
+		for (Adsp::SegmentEnvelope & envelope : m_envelopes) {
+			envelope.setTimes(delayTime, attackTime, holdTime, sustainTime, releaseTime);
+		}
+
+		//Only channel 0 has to be calculated if every channel would come out the same.
+		bool linked = inputsAreLinked();
+		for (int c = 1; c < AudioBuffer::getDefaultChannels(); c++) {
+			linked = linked && (m_envelopes[c].isReleasing() == m_envelopes[0].isReleasing())
+					&& (m_envelopes[c].getReleaseLevel() == m_envelopes[0].getReleaseLevel());
+		}
+		int channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+		//If nothing moves during the block, the output can be marked constant so that later atoms only have to read one value.
+		bool constant = automation.isConstant();
+		for (int c = 0; c < channels; c++) {
+			Adsp::SegmentEnvelope & envelope = m_envelopes[c];
+			const double * time = input.getReadData() + c * size;
+			double * output = m_outputs[0].getData() + c * size;
+			if (automation.isConstant()) {
+				envelope.setLevels(*holdLevelIter, *sustainLevelIter);
+				envelope.setShapes(*attackShapeIter, *sustainShapeIter, *releaseShapeIter);
+				if (input.isConstant()) {
+					envelope.render(time, output, 1);
+					std::fill(output + 1, output + size, output[0]);
 				} else {
-					if (time < delayTime) {
-						(*envOutput) = -1.0;
-					} else if (time < delayTime + attackTime) {
-						ltime = time - delayTime; //Time window between 0s and [attack length] seconds
-						ltime /= attackTime; //Between 0 and 1
-						(*envOutput) = Adsp::fastEnvelopeInterp(ltime, *attackShapeIter) * (*holdLevelIter) * 2.0 - 1.0;
-					} else if (time < delayTime + attackTime + holdTime) {
-						(*envOutput) = (*holdLevelIter) * 2.0 - 1.0;
-					} else if (time < delayTime + attackTime + holdTime + sustainTime) {
-						ltime = time - (delayTime + attackTime + holdTime); //Time window between 0s and [sustain length] seconds
-						ltime /= sustainTime; //Between 0 and 1
-						ltime = 1.0 - ltime;
-						(*envOutput) = Adsp::fastEnvelopeInterp(ltime, *sustainShapeIter) * 2.0 * (*holdLevelIter - *sustainLevelIter) - 1.0 + (*sustainLevelIter * 2);
-					} else {
-						(*envOutput) = (*sustainLevelIter) * 2.0 - 1.0;
-					}
-
-					if (triggerRelease) {
-						m_releasing[c] = true;
-						m_releaseStart = time;
-						m_releaseLevel[c] = (*envOutput) + 1.0;
-					}
+					bool changed = envelope.render(time, output, size);
+					constant = constant && !changed && envelope.isFlat();
+				}
+			} else {
+				//The levels and shapes can change every sample, so the envelope has to be rendered one sample at a time.
+				int timeStep = (input.isConstant()) ? 0 : 1;
+				for (int s = 0; s < size; s++) {
+					envelope.setLevels(*holdLevelIter, *sustainLevelIter);
+					envelope.setShapes(*attackShapeIter, *sustainShapeIter, *releaseShapeIter);
+					envelope.render(time + s * timeStep, output + s, 1);
+					automation.incrementPosition();
 				}
-				automation.incrementPosition();
-				io.incrementPosition();
 			}
 			automation.incrementChannel();
-			io.incrementChannel();
+		}
+		m_outputs[0].setConstant(constant); //Before linkChannels(), which only copies one sample of constant buffers.
+		if (linked) {
+			m_outputs[0].linkChannels();
+			for (int c = 1; c < AudioBuffer::getDefaultChannels(); c++) {
+				m_envelopes[c] = m_envelopes[0];
+			}
+		} else {
+			m_outputs[0].setLinked(false);
 		}
 
 		if (m_shouldUpdateParent) {
@@ -513,7 +514,7 @@ void EnvelopeAtom::execute() {
 				cursorPos = std::min(cursorPos, 1.0);
 				cursorPos *= ((delayTime + attackTime + holdTime + sustainTime) / (delayTime + attackTime + holdTime + sustainTime + releaseTime));
 			} else {
-				cursorPos += m_releaseStart;
+				cursorPos += m_envelopes[0].getReleaseStart();
 				cursorPos /= -(releaseTime);
 				cursorPos = std::min(cursorPos, 1.0);
 				cursorPos *= ((releaseTime) / (delayTime + attackTime + holdTime + sustainTime + releaseTime));
@@ -522,6 +523,7 @@ void EnvelopeAtom::execute() {
 			m_parent.m_plot.setCursorPos(cursorPos, ((*envOutput) - 1.0) / -2.0, C::CORNER_SIZE, C::CORNER_SIZE);
 		}
 	} else {
+		m_outputs[0].setConstant(true);
 		m_outputs[0].fill(-1.0);
 	}
 	/* END USER-DEFINED EXECUTION CODE */
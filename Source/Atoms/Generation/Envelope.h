@@ -6,7 +6,7 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
-
+#include "Adsp/Envelope.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
@@ -133,9 +133,7 @@ private:
 	/* END AUTO-GENERATED MEMBERS */
 
 	/* BEGIN USER-DEFINED MEMBERS */
-	std::vector<double> m_releaseLevel;
-	std::vector<bool> m_releasing;
-	double m_releaseStart;
+	std::vector<Adsp::SegmentEnvelope> m_envelopes; ///< One per channel.
 	/* END USER-DEFINED MEMBERS */
 public:
 	/* BEGIN AUTO-GENERATED METHODS */
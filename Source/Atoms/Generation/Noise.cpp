@@ -17,12 +17,12 @@ namespace AtomSynth {
 /* BEGIN MISC. USER-DEFINED CODE */
 void NoiseController::updatePlot() {
 	m_plot.clear();
-	srand(0); //So that the noise is consistent every time, and does not fluctuate wildly while tinkering with controls.
+	Adsp::CounterRandom random; //Always the same key, so that the noise is consistent every time, and does not fluctuate wildly while tinkering with controls.
 
 	double lengthTimer;
 	std::vector<double> previousValues(3, 0.0);
 	for (double & value : previousValues) {
-		value = ((double(rand()) / double(RAND_MAX)) * 2.0 - 1.0); //Randomize starting values, so that interpolation doesn't always start from 0. (That would look weird)
+		value = random.next(); //Randomize starting values, so that interpolation doesn't always start from 0. (That would look weird)
 	}
 	//This function will calculate, the amount of time traversed per pixel so that the display will show, e.g., 10*5ms of noise when the 0-10ms time range is selected.
 	double timePerPixel = m_time.getMax() / (m_time.getDisplayValue() + 1e-64) / double(m_plot.getWidth()) * 5.0; //1e-64 is to prevent /0 errors.
@@ -35,7 +35,7 @@ void NoiseController::updatePlot() {
 			lengthTimer = 0.0;
 			previousValues[2] = previousValues[1];
 			previousValues[1] = previousValues[0];
-			previousValues[0] = ((double(rand()) / double(RAND_MAX)) * 2.0 - 1.0);
+			previousValues[0] = random.next();
 		}
 
 		if (type == 0) { //sharp
@@ -187,7 +187,8 @@ NoiseAtom::NoiseAtom(NoiseController & parent, int index) :
 	m_previousValues.resize(AudioBuffer::getDefaultChannels(), std::vector<double>());
 	m_previousValues[0].resize(3, 0.0);
 	m_previousValues[1].resize(3, 0.0);
-	//m_seed is deliberately not initialized.
+	m_random.resize(AudioBuffer::getDefaultChannels());
+	m_randomValues.resize(AudioBuffer::getDefaultChannels() * AudioBuffer::getDefaultSize());
 	/* END USER-DEFINED CONSTRUCTION CODE */
 }
 
@@ -202,8 +203,19 @@ void NoiseAtom::execute() {
 	DVecIter & audioOutput = io.addOutput(m_outputs[0]);
 
 	/* BEGIN USER-DEFINED EXECUTION CODE */
-	srand(m_seed);
-	m_seed += 1;
+	//The noise only depends on the voice, the note and the channel, so a note gets the same noise in every session and every render.
+	//(The timestamp is only used to notice that a new note started, since it counts from when the synth was created.)
+	NoteState note = Synth::getInstance()->getNoteManager().getNoteState(getIndex());
+	if (note.timestamp != m_noteTimestamp) {
+		m_noteTimestamp = note.timestamp;
+		for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+			m_random[c].seed(Adsp::CounterRandom::makeKey(getIndex(), std::uint32_t(note.noteNumber), c));
+		}
+	}
+	//A value is generated for every sample, even though most of them will not be used, because generating a whole block at once is faster than generating them one at a time.
+	for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+		m_random[c].fill(&m_randomValues[c * AudioBuffer::getDefaultSize()], AudioBuffer::getDefaultSize());
+	}
 
 	double time = 1000.0 / (m_sampleRate_f * *timeIter + 0.00001);
 	if (m_parent.m_timeFrame.getSelectedLabel() == 3) //Label 3 is measured in seconds
@@ -220,7 +232,7 @@ void NoiseAtom::execute() {
 				m_lengthTimer[c] = 0.0;
 				m_previousValues[c][2] = m_previousValues[c][1];
 				m_previousValues[c][1] = m_previousValues[c][0];
-				m_previousValues[c][0] = ((double(rand()) / double(RAND_MAX)) * 2.0 - 1.0);
+				m_previousValues[c][0] = m_randomValues[c * AudioBuffer::getDefaultSize() + s];
 			}
 
 			if (type == 0) { //sharp
@@ -6,7 +6,7 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
-
+#include "Adsp/Random.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
@@ -83,7 +83,9 @@ private:
 	/* BEGIN USER-DEFINED MEMBERS */
 	std::vector<std::vector<double>> m_previousValues;
 	std::vector<double> m_lengthTimer;
-	int m_seed; //Deliberately uninitialized.
+	std::vector<Adsp::CounterRandom> m_random; ///< One per channel, seeded from the voice and the note number at the start of each note, so every render of a song has the same noise.
+	std::vector<double> m_randomValues; ///< A block of random values for each channel, from m_random.
+	unsigned long int m_noteTimestamp = -1; ///< When the note that m_random was last seeded for started. Only used to notice new notes.
 	/* END USER-DEFINED MEMBERS */
 public:
 	/* BEGIN AUTO-GENERATED METHODS */
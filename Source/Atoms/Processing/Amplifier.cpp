@@ -9,12 +9,78 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
+#include "Adsp/Vector.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
 
 /* BEGIN MISC. USER-DEFINED CODE */
+/**
+ * Converts the label selected on the mix mode button
+ * to one of the Adsp::MIX_MODE_* constants.
+ * skipMixing is set to true if only the first
+ * slider should be used.
+ */
+static int getMixMode(int label, bool & skipMixing) {
+	skipMixing = false;
+	switch(label) {
+	case 0:
+		skipMixing = true;
+		return Adsp::MIX_MODE_AVERAGE;
+	case 1:
+		return Adsp::MIX_MODE_AVERAGE;
+	case 2:
+		return Adsp::MIX_MODE_MULTIPLY;
+	case 3:
+		return Adsp::MIX_MODE_MINIMUM;
+	case 4:
+		return Adsp::MIX_MODE_MAXIMUM;
+	}
+	return Adsp::MIX_MODE_AVERAGE;
+}
 
+void AmplifierAtom::executeFused(AudioBuffer & buffer, int start, int end) {
+	bool skipMixing;
+	int mixMode = getMixMode(m_parent.m_mixMode.getSelectedLabel(), skipMixing);
+	bool clipping = m_parent.m_clip.getSelectedLabel();
+	AudioBuffer & amp1 = m_parent.m_amp1.getResult(),
+			& amp2 = m_parent.m_amp2.getResult(),
+			& clipSkew = m_parent.m_clipSkew.getResult(),
+			& clipLevel = m_parent.m_clipLevel.getResult();
+	//Constant results only have a valid value at the start of each channel.
+	int amp1Step = amp1.isConstant() ? 0 : 1,
+			amp2Step = amp2.isConstant() ? 0 : 1,
+			clipSkewStep = clipSkew.isConstant() ? 0 : 1,
+			clipLevelStep = clipLevel.isConstant() ? 0 : 1;
+	int size = AudioBuffer::getDefaultSamples();
+
+	double amp, sample;
+	int channels = (buffer.isLinked()) ? 1 : AudioBuffer::getDefaultChannels();
+	for(int c = 0; c < channels; c++) {
+		double * data = &buffer.getData()[c * size];
+		double * amp1Data = &amp1.getReadData()[c * size],
+				* amp2Data = &amp2.getReadData()[c * size],
+				* clipSkewData = &clipSkew.getReadData()[c * size],
+				* clipLevelData = &clipLevel.getReadData()[c * size];
+		if(skipMixing && (amp1Step == 0) && !clipping) {
+			Adsp::scaleBlock(data + start, amp1Data[0], data + start, end - start);
+			continue;
+		}
+		for(int s = start; s < end; s++) {
+			if(skipMixing) {
+				amp = amp1Data[s * amp1Step];
+			} else {
+				amp = Adsp::mix2(amp1Data[s * amp1Step], amp2Data[s * amp2Step], mixMode);
+			}
+			sample = Adsp::amplify(data[s], amp);
+			if(clipping) {
+				sample += clipSkewData[s * clipSkewStep];
+				sample = Adsp::clip(sample, -clipLevelData[s * clipLevelStep], clipLevelData[s * clipLevelStep]);
+			}
+			data[s] = sample;
+		}
+	}
+}
 /* END MISC. USER-DEFINED CODE */
 
 AmplifierController::AmplifierController() :
@@ -184,26 +250,8 @@ void AmplifierAtom::execute() {
 	if(signalInput == nullptr) {
 		m_outputs[0].fill(0.0);
 	} else {
-		int mixMode;
-		bool skipMixing = false;
-		switch(m_parent.m_mixMode.getSelectedLabel()) {
-		case 0:
-			mixMode = Adsp::MIX_MODE_AVERAGE;
-			skipMixing = true;
-			break;
-		case 1:
-			mixMode = Adsp::MIX_MODE_AVERAGE;
-			break;
-		case 2:
-			mixMode = Adsp::MIX_MODE_MULTIPLY;
-			break;
-		case 3:
-			mixMode = Adsp::MIX_MODE_MINIMUM;
-			break;
-		case 4:
-			mixMode = Adsp::MIX_MODE_MAXIMUM;
-			break;
-		}
+		bool skipMixing;
+		int mixMode = getMixMode(m_parent.m_mixMode.getSelectedLabel(), skipMixing);
 
 		double baseAmp, sample;
 		bool clipping = m_parent.m_clip.getSelectedLabel(), //1 = clipping.
@@ -211,36 +259,64 @@ void AmplifierAtom::execute() {
 		//True if the amplification can be calculated more efficiently ahead of time.
 		useBaseAmp = (m_parent.m_amp1.getResult().isConstant() &&
 				(m_parent.m_amp2.getResult().isConstant() || skipMixing));
-		for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++)
-		{
-			if(useBaseAmp) {
-				if(skipMixing) {
-					baseAmp = *amp1Iter;
-				} else {
-					baseAmp = Adsp::mix2(*amp1Iter, *amp2Iter, mixMode);
+		//At unity gain, the output is just the input, so there is no need to copy it.
+		//(Constant inputs are left alone, the plot expects a full buffer.)
+		if(useBaseAmp && skipMixing && !clipping && !m_primaryInputs[0]->isConstant()) {
+			bool unity = true;
+			for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+				unity = unity && (m_parent.m_amp1.getResult().getValue(c, 0) == 1.0);
+			}
+			if(unity) {
+				m_outputs[0].alias(*m_primaryInputs[0]);
+				if(m_shouldUpdateParent) {
+					m_parent.m_plot.setDataFromAudioBuffer(m_outputs[0]);
 				}
+				return;
 			}
-			for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++)
+		}
+		bool linked = inputsAreLinked();
+		int channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+		if(useBaseAmp && skipMixing && !clipping && !m_primaryInputs[0]->isConstant()) {
+			//A constant gain is just a scale, which can be done a whole channel at a time.
+			int size = AudioBuffer::getDefaultSamples();
+			for(int c = 0; c < channels; c++) {
+				Adsp::scaleBlock(m_primaryInputs[0]->getReadData() + c * size, m_parent.m_amp1.getResult().getValue(c, 0), m_outputs[0].getData() + c * size, size);
+			}
+		} else {
+			for(int c = 0; c < channels; c++)
 			{
-				//PUT YOUR EXECUTION CODE HERE
-				sample = **signalInput;
 				if(useBaseAmp) {
-					sample = Adsp::amplify(sample, baseAmp);
-				} else if(skipMixing) {
-					sample = Adsp::amplify(sample, *amp1Iter);
-				} else {
-					sample = Adsp::amplify(sample, Adsp::mix2(*amp1Iter, *amp2Iter, mixMode));
+					if(skipMixing) {
+						baseAmp = *amp1Iter;
+					} else {
+						baseAmp = Adsp::mix2(*amp1Iter, *amp2Iter, mixMode);
+					}
 				}
-				if(clipping) {
-					sample += *clipSkewIter;
-					sample = Adsp::clip(sample, -*clipLevelIter, *clipLevelIter);
+				for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++)
+				{
+					//PUT YOUR EXECUTION CODE HERE
+					sample = **signalInput;
+					if(useBaseAmp) {
+						sample = Adsp::amplify(sample, baseAmp);
+					} else if(skipMixing) {
+						sample = Adsp::amplify(sample, *amp1Iter);
+					} else {
+						sample = Adsp::amplify(sample, Adsp::mix2(*amp1Iter, *amp2Iter, mixMode));
+					}
+					if(clipping) {
+						sample += *clipSkewIter;
+						sample = Adsp::clip(sample, -*clipLevelIter, *clipLevelIter);
+					}
+					*signalOutput = sample;
+					automation.incrementPosition();
+					io.incrementPosition();
 				}
-				*signalOutput = sample;
-				automation.incrementPosition();
-				io.incrementPosition();
+				automation.incrementChannel();
+				io.incrementChannel();
 			}
-			automation.incrementChannel();
-			io.incrementChannel();
+		}
+		if(linked) {
+			m_outputs[0].linkChannels();
 		}
 
 		if(m_shouldUpdateParent) {
@@ -67,7 +67,12 @@ public:
 	/* END AUTO-GENERATED LISTENERS */
 
 	/* BEGIN USER-DEFINED METHODS */
-
+	virtual bool supportsFusion() {
+		return true;
+	}
+	virtual int getPassthroughInput(int output) {
+		return 0;
+	}
 	/* END USER-DEFINED METHODS */
 
 	friend class AmplifierAtom;
@@ -96,7 +101,7 @@ public:
 	/* END AUTO-GENERATED METHODS */
 
 	/* BEGIN USER-DEFINED METHODS */
-
+	virtual void executeFused(AudioBuffer & buffer, int start, int end);
 	/* END USER-DEFINED METHODS */
 
 	friend class AmplifierController;
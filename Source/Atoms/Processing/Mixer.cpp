@@ -9,6 +9,7 @@
 /* END AUTO-GENERATED INCLUDES */
 
 /* BEGIN USER-DEFINED INCLUDES */
+#include "Adsp/Vector.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
@@ -334,40 +335,72 @@ void MixerAtom::execute() {
 			break;
 		}
 	}
-	for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
-		for(int i : channelsToCompute) {
-			if(useBaseAmps[i]) {
-				if(c == 0) baseAmps[i] = **volIters[i] * Adsp::panLeftAmplitude(**panIters[i]); //left channel
-				else baseAmps[i] = **volIters[i] * Adsp::panRightAmplitude(**panIters[i]); //right channel
-			}
+	//If every input has a constant volume and is added to the rest, each input is just
+	//scaled and accumulated, which can be done a whole channel at a time.
+	bool blockMix = !channelsToCompute.empty();
+	for(int j = 0; j < channelsToCompute.size(); j++) {
+		index = channelsToCompute[j];
+		blockMix = blockMix && useBaseAmps[index] && !m_primaryInputs[index]->isConstant();
+		if(j > 0) {
+			blockMix = blockMix && (mixModes[channelsToCompute[j-1]] == Adsp::MIX_MODE_ADD);
 		}
-		for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++) {
+	}
+	if(blockMix) {
+		int size = AudioBuffer::getDefaultSamples();
+		for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+			double * output = m_outputs[0].getData() + c * size;
 			for(int j = 0; j < channelsToCompute.size(); j++) {
 				index = channelsToCompute[j];
-				if(useBaseAmps[index]) {
-					sample = **chIters[index] * baseAmps[index];
+				double * input = m_primaryInputs[index]->getReadData() + c * size;
+				//The volume and panning are constant, so only the first value of each channel matters.
+				double vol = (*volIters[index])[c * size], pan = (*panIters[index])[c * size];
+				double amp = vol * ((c == 0) ? Adsp::panLeftAmplitude(pan) : Adsp::panRightAmplitude(pan));
+				if(j == 0) {
+					Adsp::scaleBlock(input, amp, output, size);
 				} else {
-					if(c == 0) { //left channel
-						sample = Adsp::panLeft(**chIters[index] * **volIters[index], **panIters[index]);
-					} else {
-						sample = Adsp::panRight(**chIters[index] * **volIters[index], **panIters[index]);
-					}
+					Adsp::multiplyAddBlock(input, amp, output, size);
 				}
 				if(m_shouldUpdateParent) {
-					maxes[index+c*4] = std::max(maxes[index+c*4], std::abs(sample));
+					maxes[index+c*4] = Adsp::peakBlock(input, size) * std::abs(amp);
 				}
-				if(j == 0) { //If this is the first valid input, put it directly into the chain. Otherwise, mix it with the chain.
-					chain = sample;
-				} else {
-					chain = Adsp::mix2(chain, sample, mixModes[channelsToCompute[j-1]]);
+			}
+		}
+	} else {
+		for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+			for(int i : channelsToCompute) {
+				if(useBaseAmps[i]) {
+					if(c == 0) baseAmps[i] = **volIters[i] * Adsp::panLeftAmplitude(**panIters[i]); //left channel
+					else baseAmps[i] = **volIters[i] * Adsp::panRightAmplitude(**panIters[i]); //right channel
+				}
+			}
+			for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++) {
+				for(int j = 0; j < channelsToCompute.size(); j++) {
+					index = channelsToCompute[j];
+					if(useBaseAmps[index]) {
+						sample = **chIters[index] * baseAmps[index];
+					} else {
+						if(c == 0) { //left channel
+							sample = Adsp::panLeft(**chIters[index] * **volIters[index], **panIters[index]);
+						} else {
+							sample = Adsp::panRight(**chIters[index] * **volIters[index], **panIters[index]);
+						}
+					}
+					if(m_shouldUpdateParent) {
+						maxes[index+c*4] = std::max(maxes[index+c*4], std::abs(sample));
+					}
+					if(j == 0) { //If this is the first valid input, put it directly into the chain. Otherwise, mix it with the chain.
+						chain = sample;
+					} else {
+						chain = Adsp::mix2(chain, sample, mixModes[channelsToCompute[j-1]]);
+					}
 				}
+				*ch1Output = chain;
+				automation.incrementPosition();
+				io.incrementPosition();
 			}
-			*ch1Output = chain;
-			automation.incrementPosition();
-			io.incrementPosition();
+			automation.incrementChannel();
+			io.incrementChannel();
 		}
-		automation.incrementChannel();
-		io.incrementChannel();
 	}
 	if(m_shouldUpdateParent) {
 		m_parent.m_vol1.setAudioLevels(maxes[0], maxes[4]);
@@ -108,7 +108,9 @@ void LfoTunerAtom::execute() {
 	bool constant = m_parent.m_mult.getResult().isConstant();
 	m_outputs[0].setConstant(constant);
 	double base = m_parent.m_bpc.getHertz();
-	for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+	bool linked = inputsAreLinked();
+	int channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+	for(int c = 0; c < channels; c++) {
 		if(constant) {
 			m_outputs[0].setValue(c, 0, base * *multIter);
 		} else {
@@ -121,6 +123,9 @@ void LfoTunerAtom::execute() {
 		automation.incrementChannel();
 		io.incrementChannel();
 	}
+	if(linked) {
+		m_outputs[0].linkChannels();
+	}
 	/* END USER-DEFINED EXECUTION CODE */
 }
 
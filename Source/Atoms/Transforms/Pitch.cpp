@@ -208,7 +208,9 @@ void PitchAtom::execute() {
 	int leftSource = m_parent.m_leftSource.getSelectedLabel(),
 			rightSource = m_parent.m_rightSource.getSelectedLabel();
 	double leftFreq, rightFreq;
-	for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+	bool linked = inputsAreLinked();
+	int channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+	for(int c = 0; c < channels; c++) {
 		leftBase = (leftSource == 2) ? 440.0 : 1.0;
 		rightBase = (rightSource == 2) ? 440.0 : 1.0;
 		if(leftOctavesConst) leftBase = OctavesKnob::detune(leftBase, *leftOctavesIter);
@@ -262,6 +264,9 @@ void PitchAtom::execute() {
 		automation.incrementChannel();
 		io.incrementChannel();
 	}
+	if(linked) {
+		m_outputs[0].linkChannels();
+	}
 	/* END USER-DEFINED EXECUTION CODE */
 }
 
@@ -8,13 +8,42 @@
 
 /* BEGIN USER-DEFINED INCLUDES */
 #include "Adsp/Basic.h"
+#include "Adsp/FastMath.h"
 #include "Adsp/Remap.h"
 /* END USER-DEFINED INCLUDES */
 
 namespace AtomSynth {
 
 /* BEGIN MISC. USER-DEFINED CODE */
+double RemapAtom::remapSample(double value, int inType, int outType) {
+	if(inType == 0) { //Audio
+		value = Adsp::remap(value, -1.0, 1.0, 0.0, 1.0);
+	} else if(inType == 1) { //Linear Hz
+		value = Adsp::remap(value, 0, 20000.0, 0.0, 1.0);
+	} else if(inType == 2) { //Logarithmic Hz
+		value = std::log2(value) / LOG_MAX;
+	}
+	value = m_parent.m_plot.getValueAt(Adsp::clip(value, 0.0, 1.0));
+	if(outType == 1) {
+		value = Adsp::remap(value, -1.0, 1.0, 0.0, 20000.0);
+	} else if(outType == 2) {
+		value = Adsp::fastExp2(Adsp::remap(value, -1.0, 1.0, 0.0, 1.0) * LOG_MAX);
+	}
+	return value;
+}
 
+void RemapAtom::executeFused(AudioBuffer & buffer, int start, int end) {
+	int inType = m_parent.m_inType.getSelectedLabel(),
+			outType = m_parent.m_outType.getSelectedLabel();
+	int size = AudioBuffer::getDefaultSamples();
+	int channels = (buffer.isLinked()) ? 1 : AudioBuffer::getDefaultChannels();
+	for(int c = 0; c < channels; c++) {
+		double * data = &buffer.getData()[c * size];
+		for(int s = start; s < end; s++) {
+			data[s] = remapSample(data[s], inType, outType);
+		}
+	}
+}
 /* END MISC. USER-DEFINED CODE */
 
 RemapController::RemapController() :
@@ -125,7 +154,10 @@ void RemapAtom::execute() {
 	DVecIter & signalOutput = io.addOutput(m_outputs[0]);
 
 	/* BEGIN USER-DEFINED EXECUTION CODE */
-	if(signalInput == nullptr) return;
+	if(signalInput == nullptr) {
+		m_outputs[0].fill(0.0);
+		return;
+	}
 	double value;
 	int inType = m_parent.m_inType.getSelectedLabel(),
 			outType = m_parent.m_outType.getSelectedLabel();
@@ -144,27 +176,18 @@ void RemapAtom::execute() {
 		m_parent.m_plot.setCursorMode(PlotBase::CursorMode::CROSSHAIR);
 		m_parent.m_plot.repaintAsync();
 	}
-	for(int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+	bool linked = inputsAreLinked();
+	int channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+	for(int c = 0; c < channels; c++) {
 		for(int s = 0; s < AudioBuffer::getDefaultSamples(); s++) {
-			value = **signalInput;
-			if(inType == 0) { //Audio
-				value = Adsp::remap(value, -1.0, 1.0, 0.0, 1.0);
-			} else if(inType == 1) { //Linear Hz
-				value = Adsp::remap(value, 0, 20000.0, 0.0, 1.0);
-			} else if(inType == 2) { //Logarithmic Hz
-				value = std::log2(value) / LOG_MAX;
-			}
-			value = m_parent.m_plot.getValueAt(Adsp::clip(value, 0.0, 1.0));
-			if(outType == 1) {
-				value = Adsp::remap(value, -1.0, 1.0, 0.0, 20000.0);
-			} else if(outType == 2) {
-				value = std::pow(2.0, Adsp::remap(value, -1.0, 1.0, 0.0, 1.0) * LOG_MAX);
-			}
-			*signalOutput = value;
+			*signalOutput = remapSample(**signalInput, inType, outType);
 			io.incrementPosition();
 		}
 		io.incrementChannel();
 	}
+	if(linked) {
+		m_outputs[0].linkChannels();
+	}
 	/* END USER-DEFINED EXECUTION CODE */
 }
 
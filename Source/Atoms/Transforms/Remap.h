@@ -59,7 +59,9 @@ public:
 	/* END AUTO-GENERATED LISTENERS */
 
 	/* BEGIN USER-DEFINED METHODS */
-
+	virtual bool supportsFusion() {
+		return true;
+	}
 	/* END USER-DEFINED METHODS */
 
 	friend class RemapAtom;
@@ -88,7 +90,9 @@ public:
 	/* END AUTO-GENERATED METHODS */
 
 	/* BEGIN USER-DEFINED METHODS */
-
+	/** Remaps a single sample according to the input type, plot, and output type. */
+	double remapSample(double value, int inType, int outType);
+	virtual void executeFused(AudioBuffer & buffer, int start, int end);
 	/* END USER-DEFINED METHODS */
 
 	friend class RemapController;
@@ -789,7 +789,8 @@ void WaveformPlot::clear() {
 	PlotBase::clear();
 }
 
-void WaveformPlot::drawDataFromAudioBuffer(AudioBuffer& buf, double start, double end) {
+template<typename Buffer>
+void WaveformPlot::drawDataFromAudioBuffer(Buffer & buf, double start, double end) {
 	m_values.clear();
 	if (end == -1.0) {
 		end = buf.getSize() - 1.0;
@@ -802,6 +803,9 @@ void WaveformPlot::drawDataFromAudioBuffer(AudioBuffer& buf, double start, doubl
 	repaintAsync();
 }
 
+template void WaveformPlot::drawDataFromAudioBuffer(AudioBuffer & buf, double start, double end);
+template void WaveformPlot::drawDataFromAudioBuffer(LoopedAudioBuffer & buf, double start, double end);
+
 void DrawablePlot::draw(double x, double y) {
 	if((x < 0) || (x >= getWidth()) || (y < 0) || (y >= getHeight())) return;
 	x *= double(m_values.size() - 1) / getWidth();
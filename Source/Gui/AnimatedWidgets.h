@@ -12,6 +12,7 @@
 #include "Colours.h"
 #include "Global.h"
 #include "SimpleWidgets.h"
+#include "Adsp/FastMath.h"
 #include "Technical/AudioBuffer.h"
 #include "Technical/Automation.h"
 #include "Technical/SaveState.h"
@@ -287,7 +288,7 @@ public:
 	 * @return The detuned frequency.
 	 */
 	static double detune(double hz, double cents) {
-		return hz * pow(CENTS_INTERVAL, cents);
+		return hz * Adsp::fastExp2(cents * (1.0 / 1200.0)); //Same as pow(CENTS_INTERVAL, cents).
 	}
 };
 
@@ -308,7 +309,7 @@ public:
 	 * @return The detuned frequency.
 	 */
 	static double detune(double hz, double semitones) {
-		return hz * pow(SEMITONES_INTERVAL, semitones);
+		return hz * Adsp::fastExp2(semitones * (1.0 / 12.0)); //Same as pow(SEMITONES_INTERVAL, semitones).
 	}
 };
 
@@ -329,7 +330,7 @@ public:
 	 * @return The detuned frequency.
 	 */
 	static double detune(double hz, double octaves) {
-		return hz * pow(OCTAVES_INTERVAL, octaves);
+		return hz * Adsp::fastExp2(octaves);
 	}
 };
 
@@ -496,12 +497,15 @@ public:
 	 * use decimal indexes to retrieve one sample for
 	 * each pixel. If your AudioBuffer has antialiasing
 	 * on the AudioBuffer::get() function, it will show
-	 * up on the WaveformPlot.
+	 * up on the WaveformPlot. Works with any kind of
+	 * AudioBuffer, including LoopedAudioBuffer and the
+	 * float versions of both.
 	 * @param buf The buffer to draw data from.
 	 * @param start The index to start drawing from.
 	 * @param end The index to stop drawing at.
 	 */
-	void drawDataFromAudioBuffer(AudioBuffer & buf, double start = 0.0, double end = -1.0);
+	template<typename Buffer>
+	void drawDataFromAudioBuffer(Buffer & buf, double start = 0.0, double end = -1.0);
 	virtual void clear();
 };
 
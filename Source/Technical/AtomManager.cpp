@@ -7,12 +7,24 @@
 
 #include "AtomManager.h"
 
+#include <algorithm>
+#include <map>
+
+#include "Adsp/Vector.h"
 #include "Atoms/AtomList.h"
 #include "Technical/Log.h"
 #include "Technical/Synth.h"
 
 namespace AtomSynth {
 
+/**
+ * How many samples of each channel a fused chain
+ * processes at a time. Small enough that the tile
+ * stays in the L1 cache while every atom in the
+ * chain is applied to it.
+ */
+#define FUSED_TILE_SIZE 64
+
 void AtomManager::clearAtoms() {
 	for(auto atom : m_atoms) {
 		delete(atom);
@@ -66,14 +78,18 @@ ReallySimpleAtomProxy::ReallySimpleAtomProxy() :
 }
 
 void AtomManager::updateExecutionOrder() {
-	//Delete any atoms marked for deletion.
-	for(int i = m_atoms.size() - 1; i >= 0; i--) {
-		if(m_atoms[i]->getIsMarkedForDeletion()) {
-			for(auto atom : m_atoms) {
-				atom->cleanupInputsFromAtom(m_atoms[i]);
+	//Delete any atoms marked for deletion. The audio thread must not be
+	//in the middle of executing them.
+	{
+		const ScopedLock lock(m_lock);
+		for(int i = m_atoms.size() - 1; i >= 0; i--) {
+			if(m_atoms[i]->getIsMarkedForDeletion()) {
+				for(auto atom : m_atoms) {
+					atom->cleanupInputsFromAtom(m_atoms[i]);
+				}
+				delete(m_atoms[i]);
+				m_atoms.erase(m_atoms.begin() + i);
 			}
-			delete(m_atoms[i]);
-			m_atoms.erase(m_atoms.begin() + i);
 		}
 	}
 
@@ -92,6 +108,7 @@ void AtomManager::updateExecutionOrder() {
 		}
 	}
 
+	std::vector<std::vector<int>> steps;
 	bool running = true;
 	int remaining = proxies.size();
 	while (running) {
@@ -116,18 +133,292 @@ void AtomManager::updateExecutionOrder() {
 			index++;
 		}
 		if(!remaining) {
+			findExecutionSteps(steps);
+			updateOutputStorage(true, steps);
 			info("Network successfully compiled");
 			running = false;
 		} else if(!progress) {
 			warn("Network compile failed");
 			warn("Unable to compute paths for " + std::to_string(remaining) + " atoms.");
 			m_parent->getGuiManager().addMessage("Your patch is invalid! Make sure that it does not have any feedback loops.");
+			findExecutionSteps(steps);
+			updateOutputStorage(false, steps);
 			running = false;
 		}
 	}
 }
 
+void AtomManager::findExecutionSteps(std::vector<std::vector<int>> & steps) {
+	//Count how many inputs read from each output.
+	std::map<std::pair<AtomController *, int>, int> consumers;
+	for (AtomController * atom : m_atoms) {
+		for (std::pair<AtomController *, int> & input : atom->getAllInputs()) {
+			if (input.first != nullptr) {
+				consumers[input]++;
+			}
+		}
+	}
+
+	//An atom can be fused into the atom after it if that atom is the only
+	//thing reading its output, and it reads it through primary input 0.
+	std::vector<int> next, previous;
+	next.resize(m_atoms.size(), -1);
+	previous.resize(m_atoms.size(), -1);
+	for (int i = 0; i < m_atoms.size(); i++) {
+		if (!m_atoms[i]->supportsFusion() || m_atoms[i]->getNumPrimaryInputs() == 0)
+			continue;
+		std::pair<AtomController *, int> input = m_atoms[i]->getPrimaryInput(0);
+		if (input.first == nullptr || input.second != 0 || !input.first->supportsFusion())
+			continue;
+		if (consumers[input] != 1)
+			continue;
+		std::vector<AtomController *>::iterator source = std::find(m_atoms.begin(), m_atoms.end(), input.first);
+		if (source == m_atoms.end())
+			continue;
+		next[source - m_atoms.begin()] = i;
+		previous[i] = source - m_atoms.begin();
+	}
+
+	//Each chain is executed where its last atom would have been, since by
+	//then the inputs of every atom in the chain have been calculated.
+	steps.clear();
+	int fused = 0, chains = 0;
+	for (int index : m_atomExecutionOrder) {
+		if (next[index] != -1)
+			continue;
+		std::vector<int> step;
+		for (int i = index; i != -1; i = previous[i]) {
+			step.insert(step.begin(), i);
+		}
+		if (step.size() > 1) {
+			fused += step.size();
+			chains++;
+		}
+		steps.push_back(step);
+	}
+
+	if (fused) {
+		info("Fused " + std::to_string(fused) + " atoms into " + std::to_string(chains) + " chains");
+	}
+}
+
+/**
+ * The steps during which an output has to hold
+ * valid data. Used by AtomManager::updateOutputStorage().
+ */
+struct OutputLifetime {
+	int m_atom, ///< Index of the AtomController the output belongs to.
+		m_output, ///< Index of the output.
+		m_first, ///< The execution step that writes the output.
+		m_last, ///< The last execution step that reads the output.
+		m_samples, ///< How many samples (across all channels) the output needs.
+		m_slot; ///< Which slot of the buffer pool was assigned to it.
+};
+
+void AtomManager::updateOutputStorage(bool compiled, std::vector<std::vector<int>> & steps) {
+	//The audio thread can be reading the current arena until the lock is
+	//taken, so a new arena is always built on the side and swapped in under
+	//the lock. The old one is freed when this returns, by which point
+	//nothing points into it.
+	BufferArena arena;
+	if (!compiled) {
+		const ScopedLock lock(m_lock);
+		m_executionSteps.swap(steps);
+		m_chainAtoms.reserve(m_atoms.size());
+		for (AtomController * controller : m_atoms) {
+			for (int voice = 0; voice < Synth::getInstance()->getParameters().m_polyphony; voice++) {
+				for (int o = 0; o < controller->getNumOutputs(); o++) {
+					controller->getAtom(voice)->getOutput(o)->clearStorage();
+				}
+			}
+			for (AutomatedControl * control : controller->getAutomation().getControls()) {
+				control->getResult().clearStorage();
+			}
+		}
+		std::swap(m_arena, arena);
+		return;
+	}
+
+	std::vector<int> stepOf;
+	stepOf.resize(m_atoms.size(), 0);
+	for (int s = 0; s < steps.size(); s++) {
+		for (int index : steps[s]) {
+			stepOf[index] = s;
+		}
+	}
+
+	//Find the last step that reads each output. The input of the output
+	//atom is read after every step has run, when the voices are summed.
+	std::map<std::pair<AtomController *, int>, int> lastUse;
+	for (int i = 0; i < m_atoms.size(); i++) {
+		for (std::pair<AtomController *, int> & input : m_atoms[i]->getAllInputs()) {
+			if (input.first != nullptr) {
+				int use = (m_atoms[i]->getId() == 1) ? steps.size() : stepOf[i]; //ID for OutputController.
+				lastUse[input] = std::max(lastUse[input], use);
+			}
+		}
+	}
+
+	//Outputs can be an alias of an input, so the input has to stay alive for
+	//as long as the output does. Going backwards through the execution order
+	//handles aliases of aliases, including ones inside a fused chain, where
+	//every atom is in the same step.
+	for (int s = steps.size() - 1; s >= 0; s--) {
+		std::vector<int> & step = steps[s];
+		for (int i = step.size() - 1; i >= 0; i--) {
+			int index = step[i];
+			for (int o = 0; o < m_atoms[index]->getNumOutputs(); o++) {
+				int passthrough = m_atoms[index]->getPassthroughInput(o);
+				if (passthrough == -1)
+					continue;
+				std::pair<AtomController *, int> source = m_atoms[index]->getPrimaryInput(passthrough);
+				if (source.first != nullptr) {
+					lastUse[source] = std::max(lastUse[source], lastUse[std::make_pair(m_atoms[index], o)]);
+				}
+			}
+		}
+	}
+
+	std::vector<OutputLifetime> lifetimes;
+	for (int i = 0; i < m_atoms.size(); i++) {
+		for (int o = 0; o < m_atoms[i]->getNumOutputs(); o++) {
+			AudioBuffer * output = m_atoms[i]->getAtom(0)->getOutput(o);
+			OutputLifetime lifetime;
+			lifetime.m_atom = i;
+			lifetime.m_output = o;
+			lifetime.m_first = stepOf[i];
+			lifetime.m_last = std::max(stepOf[i], lastUse[std::make_pair(m_atoms[i], o)]);
+			lifetime.m_samples = output->getChannels() * output->getSize();
+			lifetime.m_slot = -1;
+			lifetimes.push_back(lifetime);
+		}
+	}
+	std::sort(lifetimes.begin(), lifetimes.end(), [](const OutputLifetime & a, const OutputLifetime & b) {
+		return a.m_first < b.m_first;
+	});
+
+	//Automation results are recalculated for each voice right before
+	//they are used, so they only need to be stored once, and controllers
+	//from different steps can share the same memory.
+	std::vector<std::pair<AutomatedControl *, int>> automationOffsets;
+	int automationSize = 0;
+	for (std::vector<int> & step : steps) {
+		int offset = 0;
+		for (int index : step) {
+			for (AutomatedControl * control : m_atoms[index]->getAutomation().getControls()) {
+				AudioBuffer & result = control->getResult();
+				automationOffsets.push_back(std::make_pair(control, offset));
+				offset += BufferArena::align(result.getChannels() * result.getSize());
+			}
+		}
+		automationSize = std::max(automationSize, offset);
+	}
+
+	//Give each output the first slot whose previous owner is no longer
+	//needed by the time the output is written. An output can not share
+	//with anything read during the step that writes it.
+	std::vector<int> slotFreeAfter, slotSamples;
+	for (OutputLifetime & lifetime : lifetimes) {
+		for (int slot = 0; slot < slotFreeAfter.size(); slot++) {
+			if (slotFreeAfter[slot] < lifetime.m_first) {
+				lifetime.m_slot = slot;
+				break;
+			}
+		}
+		if (lifetime.m_slot == -1) {
+			lifetime.m_slot = slotFreeAfter.size();
+			slotFreeAfter.push_back(0);
+			slotSamples.push_back(0);
+		}
+		slotFreeAfter[lifetime.m_slot] = lifetime.m_last;
+		slotSamples[lifetime.m_slot] = std::max(slotSamples[lifetime.m_slot], lifetime.m_samples);
+	}
+
+	//Slots were created in the order they are first written, so each
+	//voice's buffers are laid out in the order they are used.
+	int polyphony = Synth::getInstance()->getParameters().m_polyphony;
+	int automationStart = arena.reserve(automationSize);
+	std::vector<std::vector<int>> slotOffsets;
+	slotOffsets.resize(polyphony);
+	for (int voice = 0; voice < polyphony; voice++) {
+		for (int samples : slotSamples) {
+			slotOffsets[voice].push_back(arena.reserve(samples));
+		}
+	}
+	arena.allocate();
+
+	//Everything above only read the network, so it did not have to wait for
+	//the audio thread. The new steps and the buffers they were planned for
+	//are installed together, between two blocks.
+	{
+		const ScopedLock lock(m_lock);
+		m_executionSteps.swap(steps);
+		m_chainAtoms.reserve(m_atoms.size());
+		for (std::pair<AutomatedControl *, int> & offset : automationOffsets) {
+			offset.first->getResult().setStorage(arena.getRegion(automationStart + offset.second));
+		}
+		for (int voice = 0; voice < polyphony; voice++) {
+			for (OutputLifetime & lifetime : lifetimes) {
+				m_atoms[lifetime.m_atom]->getAtom(voice)->getOutput(lifetime.m_output)->setStorage(arena.getRegion(slotOffsets[voice][lifetime.m_slot]));
+			}
+		}
+		std::swap(m_arena, arena);
+	}
+
+	info("Assigned " + std::to_string(lifetimes.size()) + " outputs to " + std::to_string(slotSamples.size()) + " shared buffers");
+}
+
+void AtomManager::executeFusedChain(std::vector<int> & chain) {
+	int size = AudioBuffer::getDefaultSamples();
+	for (int voice = 0; voice < Synth::getInstance()->getParameters().m_polyphony; voice++) {
+		m_chainAtoms.clear();
+		for (int index : chain) {
+			m_chainAtoms.push_back(m_atoms[index]->getAtom(voice));
+		}
+
+		if (Synth::getInstance()->getNoteManager().isActive(voice)) {
+			bool fuse = true;
+			for (Atom * atom : m_chainAtoms) {
+				atom->beginExecution();
+				fuse = fuse && !atom->getShouldUpdateParent();
+			}
+			AudioBuffer * input = m_chainAtoms.front()->getPrimaryInput(0);
+			if (fuse && input != nullptr) {
+				//Only the last atom's output is ever read, so the whole
+				//chain works in place on that buffer.
+				AudioBuffer & buffer = *m_chainAtoms.back()->getOutput(0);
+				buffer.copyExpandedData(*input);
+				//The chain only has to work on one channel if everything it reads is linked.
+				bool linked = buffer.isLinked();
+				for (int index : chain) {
+					linked = linked && m_atoms[index]->getAutomation().isLinked();
+				}
+				buffer.setLinked(linked);
+				for (int start = 0; start < size; start += FUSED_TILE_SIZE) {
+					int end = std::min(start + FUSED_TILE_SIZE, size);
+					for (Atom * atom : m_chainAtoms) {
+						atom->executeFused(buffer, start, end);
+					}
+				}
+				if (linked) {
+					buffer.linkChannels();
+				}
+			} else {
+				for (Atom * atom : m_chainAtoms) {
+					atom->execute();
+					atom->endExecution();
+				}
+			}
+		} else if (Synth::getInstance()->getNoteManager().isStopped(voice)) {
+			for (Atom * atom : m_chainAtoms) {
+				atom->reset();
+			}
+		}
+	}
+}
+
 AudioBuffer & AtomManager::execute() {
+	const ScopedLock lock(m_lock);
 	if (m_atoms.size() != 0) {
 		AtomSynth::AtomController * output = nullptr;
 		//This is used in case shouldDebugEverything is set in the middle of execution.
@@ -166,8 +457,14 @@ AudioBuffer & AtomManager::execute() {
 				return m_output;
 			}
 		}
-		for (int index : m_atomExecutionOrder) {
-			m_atoms[index]->execute();
+		for (std::vector<int> & step : m_executionSteps) {
+			if (step.size() == 1 || logEverything) {
+				for (int index : step) {
+					m_atoms[index]->execute();
+				}
+			} else {
+				executeFusedChain(step);
+			}
 		}
 
 		double sample = 0.0;
@@ -175,22 +472,29 @@ AudioBuffer & AtomManager::execute() {
 		totals.resize(Synth::getInstance()->getParameters().m_polyphony, 0.0);
 		m_output.fill(0.0);
 		//Sum up all polyphony.
+		int size = AudioBuffer::getDefaultSize(), samples = AudioBuffer::getDefaultChannels() * size;
 		for (int note = 0; note < Synth::getInstance()->getParameters().m_polyphony; note++) {
-			std::vector<double>::iterator bufferIterator = input.first->getAtom(note)->getOutput(input.second)->getData().begin();
+			AudioBuffer * voiceOutput = input.first->getAtom(note)->getOutput(input.second);
+			double * bufferIterator = voiceOutput->getReadData();
 			if (Synth::getInstance()->getNoteManager().isActive(note)) {
-				for (int s = 0; s < AudioBuffer::getDefaultChannels() * AudioBuffer::getDefaultSize(); s++) {
-					sample = (*bufferIterator);
-					totals[note] += fabs(sample);
-					m_output.getData()[s] += sample;
-					bufferIterator++;
+				if (voiceOutput->isConstant()) {
+					//Outputs can be constant (e.g. if they are an alias of a constant input.)
+					for (int c = 0; c < AudioBuffer::getDefaultChannels(); c++) {
+						sample = bufferIterator[c * size];
+						totals[note] += fabs(sample) * size;
+						for (int s = 0; s < size; s++) {
+							m_output.getData()[c * size + s] += sample;
+						}
+					}
+				} else {
+					totals[note] += Adsp::sumAbsBlock(bufferIterator, samples);
+					Adsp::addBlock(bufferIterator, m_output.getData(), samples);
 				}
 			}
 		}
 
 		//Ummm... not sure what this does. I should probably remove it.
-		for (int s = 0; s < AudioBuffer::getDefaultChannels() * AudioBuffer::getDefaultSize(); s++) {
-			m_output.getData()[s] /= 2.0;
-		}
+		Adsp::scaleBlock(m_output.getData(), 0.5, m_output.getData(), samples);
 
 		int index = 0;
 		for (double total : totals) {
@@ -213,20 +517,25 @@ AudioBuffer & AtomManager::execute() {
 }
 
 void AtomManager::addAtom(AtomController* controller) {
-	m_atoms.push_back(controller);
+	{
+		const ScopedLock lock(m_lock);
+		m_atoms.push_back(controller);
+	}
 	m_atomExecutionOrder.resize(m_atoms.size(), 0);
 	updateExecutionOrder();
 	m_parent->getGuiManager().setReloadGuis();
 }
 
 void AtomManager::loadSaveState(SaveState state) {
-	clearAtoms();
+	//The new network is built on the side, so the audio thread keeps playing
+	//the old one until they are swapped.
+	std::vector<AtomController *> atoms;
 	for (SaveState & atomState : state.getStates()) {
 		for (AtomController * controller : m_availableAtoms) {
 			if (controller->getId() == int(atomState.getValue(0))) {
 				AtomController * atom = controller->createNewInstance();
 				atom->loadSaveState(atomState.getState(1));
-				m_atoms.push_back(atom);
+				atoms.push_back(atom);
 			}
 		}
 	}
@@ -236,13 +545,22 @@ void AtomManager::loadSaveState(SaveState state) {
 		int input = 0;
 		for (SaveState & inputState : atomState.getState(0).getStates()) {
 			if (inputState.getValue(0) != -1.0) {
-				m_atoms[index]->linkInput(input, m_atoms[int(inputState.getValue(0))], int(inputState.getValue(1)));
+				atoms[index]->linkInput(input, atoms[int(inputState.getValue(0))], int(inputState.getValue(1)));
 			}
 			input++;
 		}
 		index++;
 	}
 
+	{
+		const ScopedLock lock(m_lock);
+		m_atoms.swap(atoms);
+		//The old steps index into the old atoms.
+		m_executionSteps.clear();
+	}
+	for (AtomController * atom : atoms) {
+		delete(atom);
+	}
 	updateExecutionOrder();
 	m_parent->getGuiManager().setReloadGuis();
 	info("Network loaded from SaveState");
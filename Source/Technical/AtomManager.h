@@ -9,7 +9,9 @@
 #define SOURCE_TECHNICAL_ATOMMANAGER_H_
 
 #include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
 #include "Atoms/Atom.h"
+#include "Technical/BufferArena.h"
 
 /*
  * Atom.h
@@ -26,12 +28,19 @@ class AtomManager {
 private:
 	std::vector<AtomController *> m_atoms;
 	std::vector<int> m_atomExecutionOrder;
+	std::vector<std::vector<int>> m_executionSteps;
+	std::vector<Atom *> m_chainAtoms;
+	BufferArena m_arena; ///< Only replaced while m_lock is held.
 	std::vector<AtomController *> m_availableAtoms;
 	AtomSynth::AudioBuffer m_output;
 	Synth * m_parent = nullptr;
+	CriticalSection m_lock; ///< Held by execute() for a whole block, and by anything that changes what execute() reads.
 	void clearAtoms();
 	void clearAvailableAtoms();
 	void setup();
+	void findExecutionSteps(std::vector<std::vector<int>> & steps);
+	void executeFusedChain(std::vector<int> & chain);
+	void updateOutputStorage(bool compiled, std::vector<std::vector<int>> & steps);
 
 	friend class Synth;
 public:
@@ -43,7 +52,16 @@ public:
 	 * objects should be executed, based on how
 	 * they are connected. TODO: Tell the user if
 	 * there is an error (which is usually caused
-	 * by circular dependencies.)
+	 * by circular dependencies.) Chains of atoms
+	 * that support fusion (see
+	 * AtomController::supportsFusion()) are grouped
+	 * into a single execution step. Outputs that
+	 * are never needed at the same time are made to
+	 * share memory. All outputs and automation
+	 * results are placed in a single BufferArena,
+	 * in the order they are used. Everything is
+	 * worked out without blocking the audio thread,
+	 * and only installed between two blocks.
 	 */
 	void updateExecutionOrder();
 	/**
@@ -13,34 +13,73 @@
 
 namespace AtomSynth {
 
-int AudioBuffer::s_size = 256, AudioBuffer::s_channels = 2;
+int AudioBufferBase::s_size = 256, AudioBufferBase::s_channels = 2;
 
-AudioBuffer::AudioBuffer() :
+template<typename T>
+BasicAudioBuffer<T>::BasicAudioBuffer() :
 		m_constant(false),
 		m_size(s_size),
 		m_channels(s_channels) {
-	m_data.resize(m_channels * m_size);
+	m_storage.resize(m_channels * m_size);
+	m_home = m_data = m_storage.data();
 }
 
-AudioBuffer::AudioBuffer(int samples) :
+template<typename T>
+BasicAudioBuffer<T>::BasicAudioBuffer(int samples) :
 		m_constant(false),
 		m_size(samples),
 		m_channels(s_channels) {
-	m_data.resize(m_channels * m_size);
+	m_storage.resize(m_channels * m_size);
+	m_home = m_data = m_storage.data();
 }
 
-AudioBuffer::AudioBuffer(int channels, int samples) :
+template<typename T>
+BasicAudioBuffer<T>::BasicAudioBuffer(int channels, int samples) :
 		m_constant(false),
 		m_size(samples),
 		m_channels(channels) {
-	m_data.resize(m_channels * m_size);
+	m_storage.resize(m_channels * m_size);
+	m_home = m_data = m_storage.data();
 }
 
-AudioBuffer::~AudioBuffer() {
+template<typename T>
+BasicAudioBuffer<T>::BasicAudioBuffer(const BasicAudioBuffer & other) :
+		m_storage(other.m_storage),
+		m_aliased(other.m_aliased),
+		m_homeConstant(other.m_homeConstant),
+		m_homeLinked(other.m_homeLinked),
+		m_size(other.m_size),
+		m_channels(other.m_channels),
+		m_constant(other.m_constant),
+		m_linked(other.m_linked) {
+	m_home = (other.m_home == other.m_storage.data()) ? m_storage.data() : other.m_home;
+	m_data = (m_aliased) ? other.m_data : m_home;
+}
+
+template<typename T>
+BasicAudioBuffer<T> & BasicAudioBuffer<T>::operator=(const BasicAudioBuffer & other) {
+	if (this != &other) {
+		m_storage = other.m_storage;
+		m_aliased = other.m_aliased;
+		m_homeConstant = other.m_homeConstant;
+		m_homeLinked = other.m_homeLinked;
+		m_size = other.m_size;
+		m_channels = other.m_channels;
+		m_constant = other.m_constant;
+		m_linked = other.m_linked;
+		m_home = (other.m_home == other.m_storage.data()) ? m_storage.data() : other.m_home;
+		m_data = (m_aliased) ? other.m_data : m_home;
+	}
+	return *this;
+}
+
+template<typename T>
+BasicAudioBuffer<T>::~BasicAudioBuffer() {
 	// TODO Auto-generated destructor stub
 }
 
-void AudioBuffer::dumpToConsole() {
+template<typename T>
+void BasicAudioBuffer<T>::dumpToConsole() {
 	std::cout << std::endl;
 	for (int c = 0; c < m_channels; c++) {
 		std::cout << "C" << c << "\t";
@@ -54,100 +93,202 @@ void AudioBuffer::dumpToConsole() {
 	}
 }
 
-void AtomSynth::AudioBuffer::copyData(AudioBuffer & copyFrom) {
+template<typename T>
+void BasicAudioBuffer<T>::copyData(BasicAudioBuffer & copyFrom) {
+	makeUnique();
 	int channels = std::min(copyFrom.getChannels(), m_channels);
 	int samples = std::min(copyFrom.getSize(), m_size);
+	//Whole channels at once, std::copy turns this into a memmove.
 	for (int c = 0; c < channels; c++) {
-		for (int s = 0; s < samples; s++) {
-			m_data[c * m_size + s] = copyFrom.getValue(c, s);
-		}
+		std::copy(copyFrom.m_data + c * copyFrom.m_size, copyFrom.m_data + c * copyFrom.m_size + samples, m_data + c * m_size);
 	}
+	m_linked = copyFrom.isLinked() && (channels == m_channels) && (samples == m_size);
 }
 
-void AudioBuffer::copyData(AudioBuffer & copyFrom, int sampleOffset, int channelOffset) {
+template<typename T>
+void BasicAudioBuffer<T>::copyData(BasicAudioBuffer & copyFrom, int sampleOffset, int channelOffset) {
+	makeUnique();
 	int channels = std::min(copyFrom.getChannels(), m_channels - channelOffset);
 	int samples = std::min(copyFrom.getSize(), m_size - sampleOffset);
 	for (int c = 0, cd = channelOffset; c < channels; c++, cd++) {
-		for (int s = 0, sd = sampleOffset; s < samples; s++, sd++) {
-			m_data[cd * m_size + sd] = copyFrom.getValue(c, s);
+		std::copy(copyFrom.m_data + c * copyFrom.m_size, copyFrom.m_data + c * copyFrom.m_size + samples, m_data + cd * m_size + sampleOffset);
+	}
+	m_linked = false;
+}
+
+template<typename T>
+void BasicAudioBuffer<T>::copyExpandedData(BasicAudioBuffer & copyFrom) {
+	unalias();
+	if (copyFrom.isConstant()) {
+		int channels = std::min(copyFrom.getChannels(), m_channels);
+		for (int c = 0; c < channels; c++) {
+			std::fill(m_data + c * m_size, m_data + (c + 1) * m_size, copyFrom.getValue(c, 0));
 		}
+		m_linked = copyFrom.isLinked() && (channels == m_channels);
+	} else {
+		copyData(copyFrom);
 	}
+	m_constant = false;
 }
 
-void AudioBuffer::offsetData(int offset) {
+template<typename T>
+void BasicAudioBuffer<T>::offsetData(int offset) {
+	makeUnique();
 	if (offset < 0) {
 		offset *= -1;
 		for (int c = 0; c < m_channels; c++) {
-			for (int s = 0; s < m_size - offset; s++) {
-				m_data[c * m_size + s] = m_data[c * m_size + s + offset];
-			}
-			std::fill(m_data.begin() + m_size - offset + c * m_size, m_data.begin() + (c + 1) * m_size, 0.0);
+			T * channel = m_data + c * m_size;
+			std::copy(channel + offset, channel + m_size, channel);
+			std::fill(channel + m_size - offset, channel + m_size, T(0));
 		}
 	} else if (offset > 0) {
 		for (int c = 0; c < m_channels; c++) {
-			for (int s = m_size - 1; s >= offset; s--) {
-				m_data[c * m_size + s] = m_data[c * m_size + s - offset];
-			}
-			std::fill(m_data.begin() + c * m_size, m_data.begin() + offset - 1 + c * m_size, 0.0);
+			T * channel = m_data + c * m_size;
+			std::copy_backward(channel, channel + m_size - offset, channel + m_size);
+			std::fill(channel, channel + offset, T(0));
 		}
 	}
 }
 
-void AudioBuffer::fill(double value) {
+template<typename T>
+void BasicAudioBuffer<T>::fill(T value) {
+	unalias();
+	m_linked = true;
 	if (m_constant) {
 		for (int c = 0; c < s_channels; c++) {
 			m_data[s_size * c] = value;
 		}
 	} else {
-		std::fill(m_data.begin(), m_data.end(), value);
+		std::fill(m_data, m_data + m_size * m_channels, value);
+	}
+}
+
+template<typename T>
+void BasicAudioBuffer<T>::copyAliasedData() {
+	std::copy(m_data, m_data + m_size * m_channels, m_home);
+	m_data = m_home;
+	m_aliased = false;
+}
+
+template<typename T>
+void BasicAudioBuffer<T>::alias(BasicAudioBuffer & source) {
+	if (&source == this)
+		return;
+	if (!m_aliased) {
+		m_homeConstant = m_constant;
+		m_homeLinked = m_linked;
 	}
+	m_data = source.m_data;
+	m_constant = source.m_constant;
+	m_linked = source.m_linked;
+	m_aliased = true;
 }
 
-void AudioBuffer::setSize(int size) {
+template<typename T>
+void BasicAudioBuffer<T>::linkChannels() {
+	makeUnique();
+	int samples = (m_constant) ? 1 : m_size;
+	for (int c = 1; c < m_channels; c++) {
+		std::copy(m_data, m_data + samples, m_data + c * m_size);
+	}
+	m_linked = true;
+}
+
+template<typename T>
+bool BasicAudioBuffer<T>::holdsOneValue() {
+	int channels = (m_linked) ? 1 : m_channels, samples = (m_constant) ? 1 : m_size;
+	T first = m_data[0];
+	for (int c = 0; c < channels; c++) {
+		for (int s = 0; s < samples; s++) {
+			if (m_data[c * m_size + s] != first) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template<typename T>
+void BasicAudioBuffer<T>::setStorage(T * data) {
+	std::vector<T>().swap(m_storage);
+	m_home = data;
+	if (!m_aliased)
+		m_data = m_home;
+}
+
+template<typename T>
+void BasicAudioBuffer<T>::clearStorage() {
+	if (hasExternalStorage()) {
+		m_storage.assign(m_home, m_home + m_size * m_channels);
+		m_home = m_storage.data();
+		if (!m_aliased)
+			m_data = m_home;
+	}
+}
+
+template<typename T>
+void BasicAudioBuffer<T>::setSize(int size) {
+	makeUnique();
+	clearStorage();
 	m_size = size;
-	m_data.resize(m_size * m_channels, 0.0);
+	m_storage.resize(m_size * m_channels, 0.0);
+	m_home = m_data = m_storage.data();
 }
 
-void AudioBuffer::setChannels(int channels) {
+template<typename T>
+void BasicAudioBuffer<T>::setChannels(int channels) {
+	makeUnique();
+	clearStorage();
 	m_channels = channels;
-	m_data.resize(m_size * m_channels, 0.0);
+	m_storage.resize(m_size * m_channels, 0.0);
+	m_home = m_data = m_storage.data();
 }
 
-void LoopedAudioBuffer::offsetData(int amount) {
+template<typename T>
+void BasicLoopedAudioBuffer<T>::offsetData(int amount) {
+	this->makeUnique();
 	m_dataOffset += amount;
-	if(m_dataOffset >= m_size) {
-		m_dataOffset -= m_size;
+	if(m_dataOffset >= this->m_size) {
+		m_dataOffset -= this->m_size;
 	} else if (m_dataOffset < 0) {
-		m_dataOffset += m_size;
+		m_dataOffset += this->m_size;
 	}
 }
 
-double LoopedAudioBuffer::getValue(int channel, int sample) {
+template<typename T>
+T BasicLoopedAudioBuffer<T>::getValue(int channel, int sample) {
 	sample -= m_dataOffset;
-	if(sample >= m_size) {
-		sample -= m_size;
+	if(sample >= this->m_size) {
+		sample -= this->m_size;
 	} else if (sample < 0) {
-		sample += m_size;
+		sample += this->m_size;
 	}
-	return m_data[channel * m_size + sample];
+	return this->m_data[channel * this->m_size + sample];
 }
 
-void LoopedAudioBuffer::setValue(int channel, int sample, double value) {
+template<typename T>
+void BasicLoopedAudioBuffer<T>::setValue(int channel, int sample, T value) {
+	this->makeUnique();
 	sample -= m_dataOffset;
-	if(sample >= m_size) {
-		sample -= m_size;
+	if(sample >= this->m_size) {
+		sample -= this->m_size;
 	} else if (sample < 0) {
-		sample += m_size;
+		sample += this->m_size;
 	}
-	m_data[channel * m_size + sample] = value;
+	this->m_data[channel * this->m_size + sample] = value;
 }
 
-double LoopedAudioBuffer::get(int channel, double sample) {
+template<typename T>
+T BasicLoopedAudioBuffer<T>::get(int channel, double sample) {
 	return getValue(channel, int(sample + 0.5));
 }
 
-void LoopedAudioBuffer::set(int channel, double sample, double value) {
+template<typename T>
+void BasicLoopedAudioBuffer<T>::set(int channel, double sample, T value) {
 	setValue(channel, int(sample + 0.5), value);
 }
 
+template class BasicAudioBuffer<double>;
+template class BasicLoopedAudioBuffer<double>;
+
 } /* namespace AtomSynth */
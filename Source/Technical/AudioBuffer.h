@@ -12,6 +12,65 @@
 
 namespace AtomSynth {
 
+/**
+ * Holds the default size and number of channels
+ * shared by every type of BasicAudioBuffer.
+ */
+class AudioBufferBase {
+protected:
+	static int s_size, s_channels;
+public:
+	/**
+	 * Sets the default number of samples a
+	 * newly created AudioBuffer should have
+	 * in each channel. This should only be
+	 * used after finding out e.g. the buffer
+	 * size requested of the synth from a
+	 * DAW.
+	 * @param size The desired number of samples in each channel.
+	 */
+	static void setDefaultSize(int size) {
+		s_size = size;
+	}
+	/**
+	 * Sets the default number of channels a
+	 * newly created AudioBuffer should have.
+	 * This should only be used after finding
+	 * out e.g. the number of channels requested
+	 * of the synth from a DAW.
+	 * @param channels The desired number of channels.
+	 */
+	static void setDefaultChannels(int channels) {
+		s_channels = channels;
+	}
+	/**
+	 * Sets the default number of samples a
+	 * newly created AudioBuffer should have
+	 * in each channel.
+	 * @return The default number of samples in each channel.
+	 */
+	static int getDefaultSize() {
+		return s_size;
+	}
+	/**
+	 * Sets the default number of samples a
+	 * newly created AudioBuffer should have
+	 * in each channel.
+	 * @return The default number of samples in each channel.
+	 */
+	static int getDefaultSamples() {
+		return s_size;
+	}
+	/**
+	 * Gets the default number of channels a
+	 * newly created AudioBuffer should have.
+	 * @return The default number of channels.
+	 */
+	static int getDefaultChannels() {
+		return s_channels;
+	}
+};
+
 /**
  * A container to hold audio samples. Samples
  * are grouped into an arbitrary number of
@@ -42,34 +101,82 @@ namespace AtomSynth {
  * calculated, since calculating every single
  * sample would yield an almost unchanging
  * value.)
+ * Buffers can also be 'linked', meaning that
+ * every channel holds exactly the same data.
+ * Most signals are mono until something pans
+ * them, so atoms that see only linked inputs
+ * can calculate channel 0 and copy it to the
+ * other channels with linkChannels(). Like the
+ * constant flag, the linked flag is not changed
+ * by writing to the buffer, except through
+ * fill() and the copying methods.
+ * The type of the samples is T. Only doubles
+ * are instantiated (AudioBuffer), since IOSet,
+ * the automation and every atom work on doubles.
+ * None of the accessors are virtual, so they can
+ * be inlined into the loops that use them.
  */
-class AudioBuffer {
+template<typename T>
+class BasicAudioBuffer : public AudioBufferBase {
 private:
-	static int s_size, s_channels;
+	std::vector<T> m_storage;
+	T * m_home;
+	bool m_aliased = false, m_homeConstant = false, m_homeLinked = false;
 protected:
-	std::vector<double> m_data;
+	T * m_data;
 	int m_size, m_channels;
-	bool m_constant;
+	bool m_constant, m_linked = false;
+	/**
+	 * If this buffer is an alias of another buffer (see
+	 * alias()), copies the other buffer's data into this
+	 * buffer's own memory so that it can be written to
+	 * without changing the other buffer. Call this
+	 * before writing to m_data.
+	 */
+	void makeUnique() {
+		if (m_aliased) {
+			copyAliasedData();
+		}
+	}
+	/**
+	 * Does the work for makeUnique().
+	 */
+	void copyAliasedData();
 public:
 	/**
 	 * Create an audio buffer with the default
 	 * length and number of channels.
 	 */
-	AudioBuffer();
+	BasicAudioBuffer();
 	/**
 	 * Create an audio buffer with a different
 	 * length, but the default number of channels.
 	 * @param samples The number of samples in a single channel.
 	 */
-	AudioBuffer(int samples);
+	BasicAudioBuffer(int samples);
 	/**
 	 * Create an audio buffer with a different length
 	 * and a different number of channels.
 	 * @param channels The number of channels to create.
 	 * @param samples The number of samples in a single channel.
 	 */
-	AudioBuffer(int channels, int samples);
-	virtual ~AudioBuffer();
+	BasicAudioBuffer(int channels, int samples);
+	/**
+	 * Copy constructor. If the buffer being copied
+	 * uses external storage (see setStorage()), the
+	 * copy will use the same external storage.
+	 * Otherwise, the copy gets its own copy of the
+	 * data.
+	 * @param other The AudioBuffer to copy.
+	 */
+	BasicAudioBuffer(const BasicAudioBuffer & other);
+	/**
+	 * Assignment operator. See the copy constructor.
+	 * @param other The AudioBuffer to copy.
+	 * @return A reference to this AudioBuffer.
+	 */
+	BasicAudioBuffer & operator=(const BasicAudioBuffer & other);
+	~BasicAudioBuffer();
 
 	/**
 	 * Outputs the contents of the audio buffer to the
@@ -85,7 +192,7 @@ public:
 	 * used
 	 * @param copyFrom The AudioBuffer to copy data from.
 	 */
-	void copyData(AudioBuffer & copyFrom);
+	void copyData(BasicAudioBuffer & copyFrom);
 	/**
 	 * Copies data from another audio buffer to this
 	 * audio buffer, with an optional offset. If the
@@ -98,7 +205,15 @@ public:
 	 * @param sampleOffset What sample index to start copying at.
 	 * @param channelOffset What channel index to start copying at.
 	 */
-	void copyData(AudioBuffer & copyFrom, int sampleOffset, int channelOffset = 0);
+	void copyData(BasicAudioBuffer & copyFrom, int sampleOffset, int channelOffset = 0);
+	/**
+	 * Like copyData(BasicAudioBuffer & copyFrom), except
+	 * that if copyFrom is constant, each channel is
+	 * filled with that channel's constant value. This
+	 * buffer is marked as not constant afterwards.
+	 * @param copyFrom The AudioBuffer to copy data from.
+	 */
+	void copyExpandedData(BasicAudioBuffer & copyFrom);
 	/**
 	 * Moves all data in the buffer by an offset. The
 	 * offset can be positive or negative. Samples that
@@ -115,20 +230,94 @@ public:
 	 * [1, 3, 2, 0, 0]
 	 * @param offset The number of samples to offset the data by.
 	 */
-	virtual void offsetData(int offset);
+	void offsetData(int offset);
 	/**
 	 * Fills the entire buffer with a single value.
 	 * @param value The value to fill the AudioBuffer with.
 	 */
-	virtual void fill(double value);
+	void fill(T value);
 
 	/**
-	 * Gets the underlying data vector.
-	 * @return The raw data vector of the buffer.
+	 * Gets a pointer to the underlying data, for
+	 * writing to. There are getChannels() * getSize()
+	 * samples, laid out as described in the
+	 * description of AudioBuffer. If the buffer is an
+	 * alias of another buffer, it stops being one.
+	 * (See alias().)
+	 * @return A pointer to the raw data of the buffer.
+	 */
+	T * getData() {
+		makeUnique();
+		return m_data;
+	}
+	/**
+	 * Like getData(), but only for reading. This
+	 * never copies data, even if the buffer is an
+	 * alias of another buffer. Do not write to the
+	 * returned data.
+	 * @return A pointer to the raw data of the buffer.
 	 */
-	std::vector<double> & getData() {
+	T * getReadData() {
 		return m_data;
 	}
+	/**
+	 * Makes this buffer show the contents of another
+	 * buffer, without copying anything. Use this
+	 * instead of copyData() when an output is just a
+	 * copy of an input. The other buffer must not be
+	 * changed while this buffer is being read. If
+	 * anything is written to this buffer, the data is
+	 * copied first, so that the other buffer is left
+	 * alone. The constant and linked flags are copied
+	 * as well, and restored by unalias().
+	 * @param source The AudioBuffer whose contents should be shown.
+	 */
+	void alias(BasicAudioBuffer & source);
+	/**
+	 * Stops being an alias of another buffer, without
+	 * copying its data. Afterwards, the contents of the
+	 * buffer should be considered to be garbage.
+	 */
+	void unalias() {
+		if (m_aliased) {
+			m_data = m_home;
+			m_constant = m_homeConstant;
+			m_linked = m_homeLinked;
+			m_aliased = false;
+		}
+	}
+	/**
+	 * Returns true if this buffer is currently an
+	 * alias of another buffer. (See alias().)
+	 * @return True if this buffer is an alias.
+	 */
+	bool isAliased() {
+		return m_aliased;
+	}
+	/**
+	 * Makes the buffer read and write its samples
+	 * from memory that it does not own, instead of
+	 * its own memory. The buffer's own memory is
+	 * freed. Previous data is not preserved. This is
+	 * used by AtomManager to let outputs that are
+	 * never alive at the same time share memory.
+	 * @param data Pointer to at least getChannels() * getSize() samples. Must stay valid until setStorage() or clearStorage() is called again.
+	 */
+	void setStorage(T * data);
+	/**
+	 * Makes the buffer go back to using its own
+	 * memory after setStorage() has been called.
+	 * The current data is copied over.
+	 */
+	void clearStorage();
+	/**
+	 * Returns true if setStorage() has been used to
+	 * make this buffer use memory it does not own.
+	 * @return True if the buffer uses external storage.
+	 */
+	bool hasExternalStorage() {
+		return m_home != m_storage.data();
+	}
 	/**
 	 * Gets a value on a particular channel at a
 	 * particular sample.
@@ -136,7 +325,7 @@ public:
 	 * @param sample The index of the sample to retrieve.
 	 * @return The sample at the requested position.
 	 */
-	virtual double getValue(int channel, int sample) {
+	T getValue(int channel, int sample) {
 		return m_data[channel * m_size + sample];
 	}
 	/**
@@ -146,7 +335,8 @@ public:
 	 * @param sample The index of the sample to set.
 	 * @param value The value to set the sample to.
 	 */
-	virtual void setValue(int channel, int sample, double value) {
+	void setValue(int channel, int sample, T value) {
+		makeUnique();
 		m_data[channel * m_size + sample] = value;
 	}
 	/**
@@ -158,7 +348,7 @@ public:
 	 * @param sample The sample position to get the value from. Can be a decimal value.
 	 * @return The value at that position. (Not interpolated, use one of the subclasses if you want interpolation.)
 	 */
-	virtual double get(int channel, double sample) {
+	T get(int channel, double sample) {
 		return m_data[channel * m_size + int(sample + 0.5)];
 	}
 	/**
@@ -170,7 +360,8 @@ public:
 	 * @param sample The sample position to set the value on. Can be a decimal value.
 	 * @return The value to set.
 	 */
-	virtual void set(int channel, double sample, double value) {
+	void set(int channel, double sample, T value) {
+		makeUnique();
 		m_data[channel * m_size + int(sample + 0.5)] = value;
 	}
 
@@ -193,6 +384,44 @@ public:
 	bool isConstant() {
 		return m_constant;
 	}
+	/**
+	 * Marks the AudioBuffer as having the same data
+	 * on every channel. (See the description of
+	 * linked audio buffers in the description of
+	 * AudioBuffer.) This does not change any data,
+	 * use linkChannels() for that.
+	 * @param linked True if every channel should be considered to be identical.
+	 */
+	void setLinked(bool linked) {
+		m_linked = linked;
+	}
+	/**
+	 * Gets if the AudioBuffer has been marked as
+	 * having the same data on every channel. (See
+	 * the description of linked audio buffers in
+	 * the description of AudioBuffer.)
+	 * @return True if every channel is identical.
+	 */
+	bool isLinked() {
+		return m_linked;
+	}
+	/**
+	 * Checks if every sample of every channel has
+	 * the same value, whether or not the buffer has
+	 * been marked as constant. Unlike isConstant(),
+	 * this reads the data, so it can find buffers
+	 * that were filled with one value by an atom
+	 * that does not mark its outputs as constant.
+	 * @return True if the whole buffer holds one value.
+	 */
+	bool holdsOneValue();
+	/**
+	 * Copies the contents of channel 0 to every
+	 * other channel, and marks the buffer as
+	 * linked. Call this after calculating only
+	 * the first channel.
+	 */
+	void linkChannels();
 
 	/**
 	 * Sets the number of samples in each channel.
@@ -236,72 +465,35 @@ public:
 	int getChannels() {
 		return m_channels;
 	}
-
-	/**
-	 * Sets the default number of samples a
-	 * newly created AudioBuffer should have
-	 * in each channel. This should only be
-	 * used after finding out e.g. the buffer
-	 * size requested of the synth from a
-	 * DAW.
-	 * @param size The desired number of samples in each channel.
-	 */
-	static void setDefaultSize(int size) {
-		s_size = size;
-	}
-	/**
-	 * Sets the default number of channels a
-	 * newly created AudioBuffer should have.
-	 * This should only be used after finding
-	 * out e.g. the number of channels requested
-	 * of the synth from a DAW.
-	 * @param channels The desired number of channels.
-	 */
-	static void setDefaultChannels(int channels) {
-		s_channels = channels;
-	}
-	/**
-	 * Sets the default number of samples a
-	 * newly created AudioBuffer should have
-	 * in each channel.
-	 * @return The default number of samples in each channel.
-	 */
-	static int getDefaultSize() {
-		return s_size;
-	}
-	/**
-	 * Sets the default number of samples a
-	 * newly created AudioBuffer should have
-	 * in each channel.
-	 * @return The default number of samples in each channel.
-	 */
-	static int getDefaultSamples() {
-		return s_size;
-	}
-	/**
-	 * Gets the default number of channels a
-	 * newly created AudioBuffer should have.
-	 * @return The default number of channels.
-	 */
-	static int getDefaultChannels() {
-		return s_channels;
-	}
 };
 
-class LoopedAudioBuffer : public AudioBuffer {
+typedef BasicAudioBuffer<double> AudioBuffer;
+
+/**
+ * An AudioBuffer where offsetData() does not move
+ * any data, it just changes where sample 0 is. Data
+ * that is pushed off one end comes back on the other
+ * end. Since the accessors are not virtual, a
+ * BasicLoopedAudioBuffer has to be used through its
+ * own type, not through a BasicAudioBuffer reference.
+ */
+template<typename T>
+class BasicLoopedAudioBuffer : public BasicAudioBuffer<T> {
 private:
 	int m_dataOffset = 0;
 public:
-	LoopedAudioBuffer() : AudioBuffer() { }
-	LoopedAudioBuffer(int samples) : AudioBuffer(samples) { }
-	LoopedAudioBuffer(int channels, int samples) : AudioBuffer(channels, samples) { }
-	virtual void offsetData(int amount);
-	virtual double getValue(int channel, int sample);
-	virtual void setValue(int channel, int sample, double value);
-	virtual double get(int channel, double sample);
-	virtual void set(int channel, double sample, double value);
+	BasicLoopedAudioBuffer() : BasicAudioBuffer<T>() { }
+	BasicLoopedAudioBuffer(int samples) : BasicAudioBuffer<T>(samples) { }
+	BasicLoopedAudioBuffer(int channels, int samples) : BasicAudioBuffer<T>(channels, samples) { }
+	void offsetData(int amount);
+	T getValue(int channel, int sample);
+	void setValue(int channel, int sample, T value);
+	T get(int channel, double sample);
+	void set(int channel, double sample, T value);
 };
 
+typedef BasicLoopedAudioBuffer<double> LoopedAudioBuffer;
+
 } /* namespace AtomSynth */
 
 #endif /* SOURCE_TECHNICAL_AUDIOBUFFER_H_ */
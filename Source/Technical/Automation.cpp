@@ -7,6 +7,7 @@
 
 #include "Automation.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -114,6 +115,65 @@ bool AutomatedControl::isAutomated() {
 	return false;
 }
 
+void AutomatedControl::getReachableRange(double & min, double & max) {
+	if (!isAutomated()) {
+		min = max = getValue();
+		return;
+	}
+	//Same ranges as calculateAutomation() uses.
+	double kmax = (m_bounded) ? m_max : getValue(), kmin = (m_bounded) ? m_min : -getValue();
+	double divisor = 0.0;
+	for (AutomationInfluence inf : m_influences) {
+		if (inf.m_inputIndex != -1) {
+			divisor++;
+		}
+	}
+	divisor = 1.0 / divisor;
+	switch (m_mixMode) {
+	case MixMode::AVERAGE:
+		min = max = 0.0;
+		break;
+	case MixMode::MULTIPLY:
+		min = max = 1.0;
+		break;
+	case MixMode::MINIMUM:
+		min = max = m_max;
+		break;
+	case MixMode::MAXIMUM:
+		min = max = m_min;
+		break;
+	}
+	for (AutomationInfluence inf : m_influences) {
+		if (inf.m_inputIndex == -1) {
+			continue;
+		}
+		//An input of -1 gives m_minRange of the way through the range, and 1 gives m_maxRange.
+		double first = kmin + (kmax - kmin) * inf.m_minRange, second = kmin + (kmax - kmin) * inf.m_maxRange;
+		double low = std::min(first, second), high = std::max(first, second);
+		switch (m_mixMode) {
+		case MixMode::AVERAGE:
+			min += low * divisor;
+			max += high * divisor;
+			break;
+		case MixMode::MULTIPLY: {
+			//The extremes of a product of ranges are always products of their ends.
+			double products[4] = { min * low, min * high, max * low, max * high };
+			min = *std::min_element(products, products + 4);
+			max = *std::max_element(products, products + 4);
+			break;
+		}
+		case MixMode::MINIMUM:
+			min = std::min(min, low);
+			max = std::min(max, high);
+			break;
+		case MixMode::MAXIMUM:
+			min = std::max(min, low);
+			max = std::max(max, high);
+			break;
+		}
+	}
+}
+
 void AutomatedControl::loadSaveState(SaveState state) {
 	m_value = state.getNextValue();
 	m_mixMode = static_cast<MixMode>(int(state.getNextValue()));
@@ -246,19 +306,33 @@ void AutomatedControl::calculateAutomation(std::vector<AutomatedControl *> & con
 	}
 
 	double value;
-	std::vector<double>::iterator input, output;
+	double * input, * output;
 	double mValue, aValue;
-	bool isInt = false;
+	bool isInt = false, linked;
+	int channels, step;
 	for (int n : calculateIndexes) {
 		isInt = controls[n]->m_int;
 		divisor = divisors[n];
+		//If every source is the same on all channels, so is the result.
+		linked = true;
 		for (int s = 0; s < 4; s++) {
 			if (sources[n][s] != nullptr) {
-				output = controls[n]->m_result.getData().begin();
-				input = sources[n][s]->getData().begin();
+				linked = linked && sources[n][s]->isLinked();
+			}
+		}
+		channels = (linked) ? 1 : AudioBuffer::getDefaultChannels();
+		for (int s = 0; s < 4; s++) {
+			if (sources[n][s] != nullptr) {
+				output = controls[n]->m_result.getData();
 				mValue = multiply[n][s];
 				aValue = add[n][s];
-				for (int i = 0; i < AudioBuffer::getDefaultChannels() * AudioBuffer::getDefaultSize(); i++) {
+				//Constant sources only have one meaningful value per channel.
+				step = (sources[n][s]->isConstant()) ? 0 : 1;
+				for (int i = 0; i < channels * AudioBuffer::getDefaultSize(); i++) {
+					input = sources[n][s]->getReadData() + i * step;
+					if (step == 0) {
+						input += (i / AudioBuffer::getDefaultSize()) * AudioBuffer::getDefaultSize();
+					}
 					//Values come in in range -1.0 to 1.0
 					//Highly simplified version of converting from -1.0 - 1.0 to 0.0 - 1.0 to min - max to control top - control bottom
 					//Original equation is ((((sample + 1) / 2) * (max - min) + min) * (hi - low) + low ) * percent
@@ -278,19 +352,23 @@ void AutomatedControl::calculateAutomation(std::vector<AutomatedControl *> & con
 						(*output) = std::max(*output, value);
 						break;
 					}
-					input++;
 					output++;
 				}
 			}
 		}
+		if (linked) {
+			controls[n]->m_result.linkChannels();
+		} else {
+			controls[n]->m_result.setLinked(false);
+		}
 
 		if ((source.getIndex() == 0) && (source.m_shouldUpdateParent)) {
-			controls[n]->setDisplayValue(controls[n]->m_result.getData()[0]);
+			controls[n]->setDisplayValue(controls[n]->m_result.getReadData()[0]);
 		}
 	}
 }
 
-void AutomationSet::add(AutomatedControl & control, std::vector<double>::iterator & iterator) {
+void AutomationSet::add(AutomatedControl & control, double * & iterator) {
 	m_controls.push_back(&control);
 	m_iterators.push_back(&iterator);
 }
@@ -299,7 +377,7 @@ void AutomationSet::resetPosition() {
 	m_incrementIndices.clear();
 	m_constantIndices.clear();
 	for (int i = 0; i < m_controls.size(); i++) {
-		(*m_iterators[i]) = m_controls[i]->getResult().getData().begin();
+		(*m_iterators[i]) = m_controls[i]->getResult().getReadData();
 		if (m_controls[i]->getResult().isConstant()) {
 			m_constantIndices.push_back(i);
 		} else {
@@ -320,4 +398,20 @@ void AutomationSet::incrementChannel() {
 	}
 }
 
+bool AutomationSet::isLinked() {
+	for (AutomatedControl * control : m_controls) {
+		if (!control->getResult().isLinked())
+			return false;
+	}
+	return true;
+}
+
+bool AutomationSet::isConstant() {
+	for (AutomatedControl * control : m_controls) {
+		if (!control->getResult().isConstant())
+			return false;
+	}
+	return true;
+}
+
 } /* namespace AtomSynth */
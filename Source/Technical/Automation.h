@@ -324,6 +324,16 @@ public:
 	 * @return True if there are any active automation influences.
 	 */
 	bool isAutomated();
+	/**
+	 * Works out the lowest and highest values getResult()
+	 * can contain, assuming every automation input stays
+	 * between -1 and 1. If there is no automation, both are
+	 * getValue(). This can be used to prepare for every
+	 * value a control might have before it is used.
+	 * @param min Set to the lowest possible value.
+	 * @param max Set to the highest possible value.
+	 */
+	void getReachableRange(double & min, double & max);
 
 	/**
 	 * Gets a particular automation influence.
@@ -397,7 +407,7 @@ public:
 class AutomationSet {
 private:
 	std::vector<AutomatedControl *> m_controls;
-	std::vector<std::vector<double>::iterator *> m_iterators;
+	std::vector<double **> m_iterators;
 	std::vector<int> m_incrementIndices, m_constantIndices;
 public:
 	AutomationSet() {
@@ -405,6 +415,13 @@ public:
 	virtual ~AutomationSet() {
 	}
 
+	/**
+	 * Gets all AutomatedControl objects added to this.
+	 * @return A vector of all the controls in this set.
+	 */
+	std::vector<AutomatedControl *> & getControls() {
+		return m_controls;
+	}
 	/**
 	 * Clears all AutomatedControl objects added to this.
 	 */
@@ -421,7 +438,7 @@ public:
 	 * @param control The AutomatedControl to add.
 	 * @param iterator The iterator to link to the AutomatedControl.
 	 */
-	void add(AutomatedControl & control, std::vector<double>::iterator & iterator);
+	void add(AutomatedControl & control, double * & iterator);
 
 	/**
 	 * Resets all iterators to their starting positions.
@@ -442,6 +459,19 @@ public:
 	 * instead of ++.
 	 */
 	void incrementChannel();
+	/**
+	 * Returns true if the results of every control in
+	 * this set have the same data on every channel. (See
+	 * AudioBuffer::isLinked().)
+	 * @return True if all results are linked.
+	 */
+	bool isLinked();
+	/**
+	 * Returns true if the results of every control in
+	 * this set are constant. (See AudioBuffer::isConstant().)
+	 * @return True if all results are constant.
+	 */
+	bool isConstant();
 
 	/**
 	 * Clears the display values of all controls added to
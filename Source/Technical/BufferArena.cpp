@@ -0,0 +1,34 @@
+/*
+ * BufferArena.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "BufferArena.h"
+
+#include <cstdint>
+
+namespace AtomSynth {
+
+void BufferArena::clear() {
+	std::vector<double>().swap(m_storage);
+	m_data = nullptr;
+	m_size = 0;
+}
+
+int BufferArena::reserve(int samples) {
+	int offset = m_size;
+	m_size += align(samples);
+	return offset;
+}
+
+void BufferArena::allocate() {
+	//std::vector only guarantees alignment for a single double, so allocate
+	//a little extra and start at the first aligned address.
+	m_storage.assign(m_size + ALIGNMENT_SAMPLES, 0.0);
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_storage.data());
+	std::uintptr_t aligned = (address + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	m_data = m_storage.data() + (aligned - address) / sizeof(double);
+}
+
+} /* namespace AtomSynth */
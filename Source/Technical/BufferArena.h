@@ -0,0 +1,90 @@
+/*
+ * BufferArena.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_TECHNICAL_BUFFERARENA_H_
+#define SOURCE_TECHNICAL_BUFFERARENA_H_
+
+#include <vector>
+
+namespace AtomSynth {
+
+/**
+ * A single block of memory that AudioBuffer
+ * objects can be pointed at with
+ * AudioBuffer::setStorage(). Regions are handed
+ * out in the order they are requested, and each
+ * region starts on a 64-byte boundary (the size
+ * of a cache line, and the alignment needed for
+ * aligned SIMD loads.) Requesting regions in the
+ * order the buffers are used keeps everything
+ * that is used together next to each other in
+ * memory.
+ *
+ * Regions are requested with reserve() first,
+ * which only calculates offsets. Once everything
+ * has been reserved, allocate() creates the
+ * memory, and getRegion() can be used to get
+ * pointers into it.
+ */
+class BufferArena {
+private:
+	std::vector<double> m_storage;
+	double * m_data = nullptr;
+	int m_size = 0;
+public:
+	/** Alignment of every region, in bytes. */
+	static constexpr int ALIGNMENT = 64;
+	/** Alignment of every region, in samples. */
+	static constexpr int ALIGNMENT_SAMPLES = ALIGNMENT / sizeof(double);
+
+	/**
+	 * Rounds a number of samples up so that
+	 * a region of that size ends on an aligned
+	 * boundary.
+	 * @param samples The number of samples.
+	 * @return The number of samples, rounded up to a multiple of ALIGNMENT_SAMPLES.
+	 */
+	static int align(int samples) {
+		return (samples + ALIGNMENT_SAMPLES - 1) / ALIGNMENT_SAMPLES * ALIGNMENT_SAMPLES;
+	}
+
+	/**
+	 * Frees all memory and forgets all regions.
+	 */
+	void clear();
+	/**
+	 * Reserves a region of the arena. No memory
+	 * is created until allocate() is called.
+	 * @param samples The number of samples the region should hold.
+	 * @return The offset of the region, to be passed to getRegion().
+	 */
+	int reserve(int samples);
+	/**
+	 * Creates enough memory for every region
+	 * reserved so far. All samples are set to 0.
+	 */
+	void allocate();
+	/**
+	 * Gets a pointer to a reserved region. Only
+	 * valid after allocate() has been called.
+	 * @param offset An offset returned by reserve().
+	 * @return A pointer to the start of the region, aligned to ALIGNMENT bytes.
+	 */
+	double * getRegion(int offset) {
+		return m_data + offset;
+	}
+	/**
+	 * Gets the total number of samples reserved.
+	 * @return The total number of samples reserved.
+	 */
+	int getSize() {
+		return m_size;
+	}
+};
+
+} /* namespace AtomSynth */
+
+#endif /* SOURCE_TECHNICAL_BUFFERARENA_H_ */
@@ -0,0 +1,206 @@
+/*
+ * DelayLinePool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "DelayLinePool.h"
+
+#include <algorithm>
+
+namespace AtomSynth {
+
+DelayLinePool::DelayLine::DelayLine(DelayLine && other) :
+		m_line(other.m_line),
+		m_entry(other.m_entry) {
+	other.m_line = nullptr;
+	other.m_entry = -1;
+}
+
+DelayLinePool::DelayLine & DelayLinePool::DelayLine::operator=(DelayLine && other) {
+	if (this != &other) {
+		DelayLinePool::getInstance()->giveBack(*this);
+		std::swap(m_line, other.m_line);
+		std::swap(m_entry, other.m_entry);
+	}
+	return *this;
+}
+
+DelayLinePool::DelayLine::~DelayLine() {
+	DelayLinePool::getInstance()->giveBack(*this);
+}
+
+DelayLinePool::Reservation::Reservation() {
+	DelayLinePool * pool = DelayLinePool::getInstance();
+	const ScopedLock lock(pool->m_lock);
+	pool->m_reservations.push_back(this);
+}
+
+DelayLinePool::Reservation::~Reservation() {
+	DelayLinePool * pool = DelayLinePool::getInstance();
+	const ScopedLock lock(pool->m_lock);
+	pool->m_reservations.erase(std::find(pool->m_reservations.begin(), pool->m_reservations.end(), this));
+	for (Entry & entry : pool->m_entries) {
+		if (entry.m_owner.load() == this) {
+			entry.m_owner.store(nullptr); //Freed by update() once it is not taken anymore.
+		}
+	}
+}
+
+void DelayLinePool::Reservation::set(int lines, int samples) {
+	DelayLinePool * pool = DelayLinePool::getInstance();
+	const ScopedLock lock(pool->m_lock);
+	if (lines != m_lines || samples != m_samples) {
+		m_lines = lines;
+		m_samples = samples;
+		if (pool->isThreadRunning()) {
+			pool->notify();
+		} else if (lines > 0) {
+			pool->startThread(2); //Low priority, the audio thread is more important.
+		}
+	}
+}
+
+DelayLinePool::DelayLine DelayLinePool::Reservation::take(int samples) {
+	DelayLinePool * pool = DelayLinePool::getInstance();
+	DelayLine line;
+	for (int i = 0; i < MAX_LINES; i++) {
+		Entry & entry = pool->m_entries[i];
+		if (entry.m_owner.load(std::memory_order_relaxed) != this || entry.m_state.load(std::memory_order_relaxed) != FREE) {
+			continue;
+		}
+		int state = FREE;
+		if (!entry.m_state.compare_exchange_strong(state, TAKEN)) {
+			continue; //Freed by update() in the meantime.
+		}
+		if (entry.m_owner.load() != this || entry.m_size.load() < samples) {
+			entry.m_state.store(FREE); //Replaced in the meantime, or too short. It was never used so it is still clear.
+			continue;
+		}
+		line.m_line = entry.m_line.get();
+		line.m_entry = i;
+		return line;
+	}
+	return line;
+}
+
+DelayLinePool * DelayLinePool::s_instance = nullptr;
+
+DelayLinePool::DelayLinePool() :
+		Thread("delayLinePool") {
+	for (Entry & entry : m_entries) {
+		entry.m_state.store(EMPTY);
+		entry.m_size.store(0);
+		entry.m_owner.store(nullptr);
+	}
+}
+
+DelayLinePool * DelayLinePool::getInstance() {
+	if (s_instance == nullptr) {
+		s_instance = new DelayLinePool();
+	}
+	return s_instance;
+}
+
+DelayLinePool::~DelayLinePool() {
+	stop();
+}
+
+void DelayLinePool::release(Entry & entry) {
+	entry.m_line.reset();
+	entry.m_size.store(0);
+	entry.m_owner.store(nullptr);
+	entry.m_state.store(EMPTY);
+}
+
+void DelayLinePool::update() {
+	//Lines that were given back are cleared, unless their Reservation is gone or needs longer lines now.
+	for (Entry & entry : m_entries) {
+		int state = DIRTY;
+		if (entry.m_state.compare_exchange_strong(state, CLEARING)) {
+			Reservation * owner = entry.m_owner.load();
+			if (owner == nullptr || entry.m_size.load() < owner->m_samples) {
+				release(entry);
+			} else {
+				entry.m_line->clear();
+				entry.m_state.store(FREE);
+			}
+		}
+	}
+
+	//Free lines that can't be taken anymore, and count what every Reservation has.
+	std::vector<int> taken(m_reservations.size(), 0), free(m_reservations.size(), 0);
+	for (Entry & entry : m_entries) {
+		int state = entry.m_state.load();
+		if (state == EMPTY) {
+			continue;
+		}
+		Reservation * owner = entry.m_owner.load();
+		int index = int(std::find(m_reservations.begin(), m_reservations.end(), owner) - m_reservations.begin());
+		if (state == FREE) {
+			if (owner == nullptr || entry.m_size.load() < owner->m_samples) {
+				if (entry.m_state.compare_exchange_strong(state, EMPTY)) {
+					release(entry);
+				}
+				continue;
+			}
+			free[index]++;
+		} else if (owner != nullptr) {
+			taken[index]++;
+		}
+	}
+
+	//Allocate or free lines until every Reservation has its spares.
+	int empty = 0;
+	for (int r = 0; r < int(m_reservations.size()); r++) {
+		Reservation * reservation = m_reservations[r];
+		int wanted = std::max(0, std::min(int(SPARE_LINES), reservation->m_lines - taken[r]));
+		for (; free[r] < wanted; free[r]++) {
+			while (empty < MAX_LINES && m_entries[empty].m_state.load() != EMPTY) {
+				empty++;
+			}
+			if (empty == MAX_LINES) {
+				break;
+			}
+			Entry & entry = m_entries[empty];
+			entry.m_line.reset(new Adsp::DelayLine(AudioBuffer::getDefaultChannels(), reservation->m_samples));
+			entry.m_size.store(entry.m_line->getSize());
+			entry.m_owner.store(reservation);
+			entry.m_state.store(FREE); //Publishes the rest to the audio thread.
+		}
+		for (int i = 0; i < MAX_LINES && free[r] > wanted; i++) {
+			Entry & entry = m_entries[i];
+			int state = FREE;
+			if (entry.m_owner.load() == reservation && entry.m_state.compare_exchange_strong(state, EMPTY)) {
+				release(entry);
+				free[r]--;
+			}
+		}
+	}
+}
+
+void DelayLinePool::run() {
+	while (!threadShouldExit()) {
+		{
+			const ScopedLock lock(m_lock);
+			update();
+		}
+		wait(POLL_INTERVAL); //The audio thread can't wake this up without taking a lock.
+	}
+}
+
+void DelayLinePool::giveBack(DelayLine & line) {
+	if (line.m_line != nullptr) {
+		m_entries[line.m_entry].m_state.store(DIRTY);
+	}
+	line.m_line = nullptr;
+	line.m_entry = -1;
+}
+
+void DelayLinePool::stop() {
+	signalThreadShouldExit();
+	notify();
+	stopThread(1000);
+}
+
+} /* namespace AtomSynth */
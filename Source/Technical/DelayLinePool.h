@@ -0,0 +1,161 @@
+/*
+ * DelayLinePool.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_TECHNICAL_DELAYLINEPOOL_H_
+#define SOURCE_TECHNICAL_DELAYLINEPOOL_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Adsp/DelayLine.h"
+#include "Technical/AudioBuffer.h"
+
+namespace AtomSynth {
+
+/**
+ * Lends out delay lines to atoms that need a long
+ * history of their input, like CombAtom. Atom controllers
+ * say how many delay lines of what length their voices
+ * can need at most with a Reservation. The pool's own
+ * background thread then keeps SPARE_LINES free lines
+ * for every Reservation, on top of the lines its voices
+ * have taken, so memory grows with the voices that are
+ * actually playing instead of the polyphony. It checks
+ * every POLL_INTERVAL milliseconds, clears lines that
+ * were given back, and allocates or frees lines until
+ * each Reservation has its spares again. The audio
+ * thread only ever takes lines that already exist and
+ * gives them back, it never allocates, frees or clears
+ * anything.
+ *
+ * A voice that finds no free line gets an empty
+ * DelayLine. That happens when more than SPARE_LINES
+ * voices of one Reservation start within
+ * POLL_INTERVAL, or when MAX_LINES lines exist already.
+ * The voice has to deal with it, CombAtom plays its
+ * input dry and tries again every block, which in the
+ * first case succeeds once the pool has caught up.
+ */
+class DelayLinePool: public Thread {
+public:
+	static constexpr int MAX_LINES = 512, ///< The most delay lines that can exist at once.
+			SPARE_LINES = 4, ///< Free lines kept for every Reservation, so that voices that start can take one straight away.
+			POLL_INTERVAL = 5; ///< Milliseconds between the background thread's checks.
+
+	/**
+	 * A delay line taken from the pool. It is given back
+	 * when this is destroyed or assigned to.
+	 */
+	class DelayLine {
+	private:
+		Adsp::DelayLine * m_line = nullptr;
+		int m_entry = -1;
+		friend class DelayLinePool;
+	public:
+		DelayLine() {
+		}
+		DelayLine(DelayLine && other);
+		DelayLine & operator=(DelayLine && other);
+		~DelayLine();
+		explicit operator bool() const {
+			return m_line != nullptr;
+		}
+		Adsp::DelayLine & operator*() const {
+			return *m_line;
+		}
+		Adsp::DelayLine * operator->() const {
+			return m_line;
+		}
+	};
+
+	/**
+	 * How many delay lines something can need at most, and
+	 * how long they have to be. Lines are allocated for a
+	 * Reservation as its voices take them, see
+	 * DelayLinePool, and can only be taken through the
+	 * Reservation they were allocated for.
+	 */
+	class Reservation {
+	private:
+		int m_lines = 0, m_samples = 0; ///< Only used while the pool's m_lock is held.
+		friend class DelayLinePool;
+	public:
+		Reservation();
+		Reservation(const Reservation & other) = delete;
+		Reservation & operator=(const Reservation & other) = delete;
+		~Reservation();
+		/**
+		 * Changes the reservation. Should only be called from
+		 * the message thread. Lines that are too short now are
+		 * freed once they are not taken anymore.
+		 * @param lines How many delay lines can be taken at most.
+		 * @param samples How many samples each one needs in each channel.
+		 */
+		void set(int lines, int samples);
+		/**
+		 * Takes a free delay line of this reservation. It has
+		 * AudioBuffer::getDefaultChannels() channels, and every
+		 * sample is 0. Safe to call from the audio thread.
+		 * @param samples The minimum number of samples the delay line needs in each channel.
+		 * @return The delay line, or an empty one if no line that long is free.
+		 */
+		DelayLine take(int samples);
+	};
+private:
+	enum State {
+		EMPTY, ///< Has no delay line. Only the background thread uses these.
+		FREE, ///< Cleared and waiting to be taken.
+		TAKEN, ///< Lent to a voice.
+		DIRTY, ///< Given back, but not cleared yet.
+		CLEARING ///< Being cleared by run().
+	};
+	struct Entry {
+		std::unique_ptr<Adsp::DelayLine> m_line; ///< Only changed by the background thread while the entry is EMPTY.
+		std::atomic<int> m_state, m_size; ///< m_size is the size of m_line, or 0 if it is EMPTY.
+		std::atomic<Reservation *> m_owner; ///< The Reservation the line was allocated for, or nullptr once that is gone.
+	};
+	std::array<Entry, MAX_LINES> m_entries;
+	std::vector<Reservation *> m_reservations; ///< Only used while m_lock is held.
+	CriticalSection m_lock; ///< Held by the background thread while it changes lines, and by Reservation while it changes.
+	static DelayLinePool * s_instance;
+	DelayLinePool();
+	/**
+	 * Clears lines that were given back, and allocates or
+	 * frees lines until every Reservation has SPARE_LINES
+	 * free ones, or as many as its voices can still take.
+	 * Called by the background thread with m_lock held.
+	 */
+	void update();
+	/**
+	 * Frees the line of an entry that nobody can take.
+	 */
+	void release(Entry & entry);
+public:
+	static DelayLinePool * getInstance();
+	virtual ~DelayLinePool();
+
+	virtual void run();
+
+	/**
+	 * Puts a delay line back in the pool, so that it can be
+	 * taken again once it has been cleared. Safe to call
+	 * from the audio thread.
+	 * @param line The delay line. It is left empty.
+	 */
+	void giveBack(DelayLine & line);
+	/**
+	 * Stops the background thread. It starts again the next
+	 * time a Reservation changes.
+	 */
+	void stop();
+};
+
+} /* namespace AtomSynth */
+
+#endif /* SOURCE_TECHNICAL_DELAYLINEPOOL_H_ */
@@ -0,0 +1,187 @@
+/*
+ * FirCacheFile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "FirCacheFile.h"
+
+#include <cstring>
+
+#include "Technical/Log.h"
+
+namespace AtomSynth {
+
+static const char MAGIC[8] = { 'A', 'T', 'O', 'M', 'F', 'I', 'R', '\0' };
+static constexpr uint32 BYTE_ORDER_MARK = 0x01020304; ///< Reads as something else on a machine with a different byte order.
+
+FirCacheFile * FirCacheFile::s_instance = nullptr;
+
+FirCacheFile::FirCacheFile() {
+}
+
+FirCacheFile * FirCacheFile::getInstance() {
+	if (s_instance == nullptr) {
+		s_instance = new FirCacheFile();
+	}
+	return s_instance;
+}
+
+FirCacheFile::~FirCacheFile() {
+}
+
+FirCacheFile::FileHeader FirCacheFile::createHeader(int tables) {
+	FileHeader header;
+	std::memcpy(header.m_magic, MAGIC, sizeof(MAGIC));
+	header.m_version = VERSION;
+	header.m_coefficientVersion = Adsp::FirFilterCache::COEFFICIENT_VERSION;
+	header.m_byteOrder = BYTE_ORDER_MARK;
+	header.m_kernelSize = KERNEL_SIZE;
+	header.m_filters = NUM_FILTERS;
+	header.m_tables = tables;
+	return header;
+}
+
+File FirCacheFile::getDefaultFile() {
+	return File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("AtomSynth").getChildFile("FirCoefficients.cache");
+}
+
+bool FirCacheFile::load(File file) {
+	if (m_mapped != nullptr) {
+		return true;
+	}
+	if (!file.existsAsFile()) {
+		return false;
+	}
+	std::unique_ptr<MemoryMappedFile> mapped(new MemoryMappedFile(file, MemoryMappedFile::readOnly));
+	const char * data = static_cast<const char *>(mapped->getData());
+	int64 size = int64(mapped->getSize());
+	if (data == nullptr || size < int64(sizeof(FileHeader))) {
+		warn("Could not map FIR coefficient cache " + file.getFullPathName().toStdString());
+		return false;
+	}
+
+	FileHeader header, expected = createHeader(0);
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.m_magic, MAGIC, sizeof(MAGIC)) != 0 || header.m_version != expected.m_version
+			|| header.m_coefficientVersion != expected.m_coefficientVersion || header.m_byteOrder != expected.m_byteOrder
+			|| header.m_kernelSize != expected.m_kernelSize || header.m_filters != expected.m_filters) {
+		info("Ignoring FIR coefficient cache from a different version");
+		return false;
+	}
+	int64 tablesEnd = sizeof(FileHeader) + int64(header.m_tables) * sizeof(TableHeader);
+	if (tablesEnd > size) {
+		warn("FIR coefficient cache is truncated");
+		return false;
+	}
+	std::vector<TableHeader> tables(header.m_tables);
+	if (!tables.empty()) {
+		std::memcpy(tables.data(), data + sizeof(FileHeader), tables.size() * sizeof(TableHeader));
+	}
+	//Check every table before attaching any of them, so a broken file is not half used.
+	typedef Adsp::FirFilterCache Cache;
+	for (const TableHeader & table : tables) {
+		if (table.m_offset < tablesEnd || table.m_offset % ALIGNMENT != 0 || table.m_offset > size - TABLE_BYTES) {
+			warn("FIR coefficient cache is truncated");
+			return false;
+		}
+		//The filters use the tap counts to index into the kernels, so a bad one would read outside the file.
+		const int32 * taps = reinterpret_cast<const int32 *>(data + table.m_offset + int64(NUM_FILTERS) * KERNEL_SIZE * sizeof(double));
+		for (int i = 0; i < NUM_FILTERS; i++) {
+			if (taps[i] < Cache::MIN_TAPS || taps[i] > KERNEL_SIZE || taps[i] % Cache::TAPS_STEP != 0) {
+				warn("FIR coefficient cache has an invalid kernel size");
+				return false;
+			}
+		}
+	}
+
+	Cache * cache = Cache::getInstance();
+	for (const TableHeader & table : tables) {
+		const double * coefficients = reinterpret_cast<const double *>(data + table.m_offset);
+		const int * taps = reinterpret_cast<const int *>(coefficients + NUM_FILTERS * KERNEL_SIZE);
+		cache->attachTable(table.m_filterType, table.m_sampleRate, coefficients, taps);
+	}
+	m_mapped = std::move(mapped);
+	m_tables = std::move(tables);
+	info("Loaded " + std::to_string(m_tables.size()) + " FIR coefficient tables from " + file.getFullPathName().toStdString());
+	return true;
+}
+
+bool FirCacheFile::hasTable(int filterType, double sampleRate) {
+	for (const TableHeader & table : m_tables) {
+		if (table.m_filterType == filterType && table.m_sampleRate == sampleRate) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FirCacheFile::save(double sampleRate, File file) {
+	static_assert(sizeof(int) == sizeof(int32), "Tap counts are mapped straight into FirFilterCache as ints.");
+	std::vector<Adsp::FirCoefficientCache *> caches;
+	bool changed = false;
+	for (Adsp::FirCoefficientCache * cache : Adsp::FirFilterCache::getInstance()->getCaches()) {
+		bool loaded = hasTable(cache->getFilterType(), cache->getSampleRate());
+		if (loaded || cache->getSampleRate() == sampleRate) {
+			caches.push_back(cache);
+			changed = changed || !loaded;
+		}
+	}
+	if (!changed) {
+		return true;
+	}
+
+	std::vector<TableHeader> tables(caches.size());
+	int64 offset = align(sizeof(FileHeader) + tables.size() * sizeof(TableHeader));
+	for (int t = 0; t < int(tables.size()); t++) {
+		tables[t].m_filterType = caches[t]->getFilterType();
+		tables[t].m_reserved = 0;
+		tables[t].m_sampleRate = caches[t]->getSampleRate();
+		tables[t].m_offset = offset;
+		offset = align(offset + TABLE_BYTES);
+	}
+
+	file.getParentDirectory().createDirectory();
+	TemporaryFile temporary(file);
+	{
+		FileOutputStream output(temporary.getFile());
+		if (output.failedToOpen()) {
+			warn("Could not write FIR coefficient cache " + file.getFullPathName().toStdString());
+			return false;
+		}
+		FileHeader header = createHeader(tables.size());
+		output.write(&header, sizeof(header));
+		output.write(tables.data(), tables.size() * sizeof(TableHeader));
+		std::vector<double> kernel(KERNEL_SIZE);
+		std::vector<int32> taps(NUM_FILTERS);
+		for (int t = 0; t < int(tables.size()); t++) {
+			output.writeRepeatedByte(0, size_t(tables[t].m_offset - output.getPosition()));
+			Adsp::FirCoefficientCache * cache = caches[t];
+			for (int i = 0; i < NUM_FILTERS; i++) {
+				if (cache->hasTable()) {
+					output.write(cache->getTableCoefficients(i), KERNEL_SIZE * sizeof(double));
+					taps[i] = cache->getTableTaps(i);
+				} else {
+					taps[i] = Adsp::FirFilterCache::computeCoefficients(cache->getFilterType(), i, cache->getSampleRate(), kernel.data());
+					output.write(kernel.data(), KERNEL_SIZE * sizeof(double));
+				}
+			}
+			output.write(taps.data(), NUM_FILTERS * sizeof(int32));
+		}
+		output.writeRepeatedByte(0, size_t(offset - output.getPosition()));
+		output.flush();
+		if (output.getStatus().failed()) {
+			warn("Could not write FIR coefficient cache " + file.getFullPathName().toStdString());
+			return false;
+		}
+	}
+	//Moving the new file over the old one leaves the old one mapped in every process that loaded it.
+	if (!temporary.overwriteTargetFileWithTemporary()) {
+		warn("Could not replace FIR coefficient cache " + file.getFullPathName().toStdString());
+		return false;
+	}
+	info("Saved " + std::to_string(tables.size()) + " FIR coefficient tables to " + file.getFullPathName().toStdString());
+	return true;
+}
+
+} /* namespace AtomSynth */
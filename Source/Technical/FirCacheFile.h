@@ -0,0 +1,105 @@
+/*
+ * FirCacheFile.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_TECHNICAL_FIRCACHEFILE_H_
+#define SOURCE_TECHNICAL_FIRCACHEFILE_H_
+
+#include <memory>
+#include <vector>
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Adsp/CachedFir.h"
+
+namespace AtomSynth {
+
+/**
+ * Saves complete tables of FIR coefficients to disk, and
+ * maps them back into memory when the synth starts, so
+ * that Adsp::FirFilterCache does not have to compute any
+ * of them while audio is playing. The file is mapped read
+ * only, so every instance of the plugin on a machine
+ * shares one copy of it in the page cache.
+ *
+ * The file starts with a FileHeader, then one TableHeader
+ * for each table. Each table is NUM_FILTERS kernels of
+ * KERNEL_SIZE doubles, followed by NUM_FILTERS 32 bit tap
+ * counts. Everything is written in the byte order of the
+ * machine that wrote it, and files with a different byte
+ * order or version are ignored.
+ */
+class FirCacheFile {
+public:
+	static constexpr uint32 VERSION = 1; ///< Change this whenever the layout of the file changes.
+	static constexpr int KERNEL_SIZE = Adsp::FirCoefficientCache::FILTER_KERNEL_SIZE,
+			NUM_FILTERS = Adsp::FirCoefficientCache::NUM_FILTERS,
+			ALIGNMENT = 64; ///< Tables start at multiples of this many bytes, so kernels are aligned for SIMD loads.
+	static constexpr int64 TABLE_BYTES = int64(NUM_FILTERS) * KERNEL_SIZE * sizeof(double) + NUM_FILTERS * sizeof(int32);
+private:
+	struct FileHeader {
+		char m_magic[8];
+		uint32 m_version, m_coefficientVersion, m_byteOrder, m_kernelSize, m_filters, m_tables;
+	};
+	struct TableHeader {
+		int32 m_filterType, m_reserved;
+		double m_sampleRate;
+		int64 m_offset; ///< How many bytes into the file the table starts.
+	};
+	std::unique_ptr<MemoryMappedFile> m_mapped; ///< Stays mapped until the program exits, since FirFilterCache keeps pointers into it.
+	std::vector<TableHeader> m_tables; ///< The tables in m_mapped.
+	static FirCacheFile * s_instance;
+	FirCacheFile();
+	static FileHeader createHeader(int tables);
+	static int64 align(int64 bytes) {
+		return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	}
+public:
+	static FirCacheFile * getInstance();
+	~FirCacheFile();
+
+	/**
+	 * Gets the file in the user's application data folder
+	 * that every instance of the plugin shares.
+	 */
+	static File getDefaultFile();
+
+	/**
+	 * Maps a file of tables into memory and gives every
+	 * table in it to Adsp::FirFilterCache::attachTable().
+	 * Only the first file that loads successfully is used,
+	 * calling this again afterwards does nothing. Nothing is
+	 * attached if any part of the file is invalid.
+	 * @param file The file to load.
+	 * @return true if the file is (or already was) loaded.
+	 */
+	bool load(File file = getDefaultFile());
+	/**
+	 * Writes a complete table for every FirCoefficientCache
+	 * that is either at the current sample rate or was
+	 * loaded from the file before. Other sample rates are
+	 * left out, so tables that were only used briefly, like
+	 * before the host says what the sample rate is, do not
+	 * take up space. Any kernels that were never computed
+	 * are computed now, which takes a few milliseconds per
+	 * table, so this should not be called from the audio
+	 * thread. The file is written to a temporary file first
+	 * and then moved over the old one, so other instances
+	 * that have it mapped are not affected.
+	 * @param sampleRate The current sample rate.
+	 * @param file The file to write.
+	 * @return true if the file was written, or did not need to be.
+	 */
+	bool save(double sampleRate, File file = getDefaultFile());
+	/**
+	 * Checks if the loaded file has a table for a filter
+	 * type and sample rate, in which case nothing for them
+	 * will ever need to be computed.
+	 */
+	bool hasTable(int filterType, double sampleRate);
+};
+
+} /* namespace AtomSynth */
+
+#endif /* SOURCE_TECHNICAL_FIRCACHEFILE_H_ */
@@ -0,0 +1,124 @@
+/*
+ * FirPrewarmer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "FirPrewarmer.h"
+
+#include <algorithm>
+
+#include "Technical/FirCacheFile.h"
+#include "Technical/Synth.h"
+
+namespace AtomSynth {
+
+FirPrewarmer * FirPrewarmer::s_instance = nullptr;
+
+FirPrewarmer::FirPrewarmer() :
+		Thread("firPrewarmer") {
+}
+
+FirPrewarmer * FirPrewarmer::getInstance() {
+	if (s_instance == nullptr) {
+		s_instance = new FirPrewarmer();
+	}
+	return s_instance;
+}
+
+FirPrewarmer::~FirPrewarmer() {
+	stop();
+}
+
+void FirPrewarmer::run() {
+	Adsp::FirFilterCache * filterCache = Adsp::FirFilterCache::getInstance();
+	while (!threadShouldExit()) {
+		//Kernels the audio thread is already waiting for come first.
+		if (filterCache->computeRequested()) {
+			continue;
+		}
+		Request next;
+		{
+			const ScopedLock lock(m_lock);
+			if (m_requests.empty()) {
+				next.m_cache = nullptr;
+			} else {
+				next = m_requests.front();
+				m_requests.erase(m_requests.begin());
+			}
+		}
+		if (next.m_cache == nullptr) {
+			wait(POLL_INTERVAL); //The audio thread can't wake this up without taking a lock.
+			continue;
+		}
+		//Ranges from different requests often overlap, prewarm() skips anything already done.
+		for (int index = next.m_first; index <= next.m_last && !threadShouldExit();) {
+			while (filterCache->computeRequested()) {
+			}
+			if (filterCache->prewarm(next.m_cache, index)) {
+				index++;
+			} else {
+				wait(POLL_INTERVAL); //Until the audio thread has collected some of the kernels that are done.
+			}
+		}
+	}
+}
+
+Adsp::FirCoefficientCache * FirPrewarmer::prepare(int filterType, double sampleRate) {
+	//The audio thread can only use caches that exist already, even at a placeholder sample rate, and
+	//the thread has to be running to compute what it is missing.
+	Adsp::FirCoefficientCache * cache = Adsp::FirFilterCache::getInstance()->prepareCache(filterType, sampleRate);
+	if (!isThreadRunning()) {
+		startThread(2); //Low priority, the audio thread is more important.
+	}
+	//Until the host says what the sample rate is, it is only a placeholder, and kernels for it would never be used.
+	if (!Synth::getInstance()->getParameters().m_prepared || FirCacheFile::getInstance()->hasTable(filterType, sampleRate)) {
+		return nullptr;
+	}
+	return cache;
+}
+
+void FirPrewarmer::request(int filterType, double sampleRate, double lowest, double highest) {
+	Adsp::FirCoefficientCache * cache = prepare(filterType, sampleRate);
+	if (cache == nullptr) {
+		return;
+	}
+	Request request;
+	request.m_cache = cache;
+	request.m_first = Adsp::FirCoefficientCache::freqToIndex(std::min(lowest, highest));
+	request.m_last = Adsp::FirCoefficientCache::freqToIndex(std::max(lowest, highest));
+	{
+		const ScopedLock lock(m_lock);
+		m_requests.push_back(request);
+	}
+	notify();
+}
+
+void FirPrewarmer::request(int filterType, double sampleRate, const std::vector<double> & cutoffs) {
+	Adsp::FirCoefficientCache * cache = prepare(filterType, sampleRate);
+	if (cache == nullptr) {
+		return;
+	}
+	{
+		const ScopedLock lock(m_lock);
+		for (double cutoff : cutoffs) {
+			Request request;
+			request.m_cache = cache;
+			request.m_first = request.m_last = Adsp::FirCoefficientCache::freqToIndex(cutoff);
+			m_requests.push_back(request);
+		}
+	}
+	notify();
+}
+
+void FirPrewarmer::stop() {
+	{
+		const ScopedLock lock(m_lock);
+		m_requests.clear();
+	}
+	signalThreadShouldExit();
+	notify();
+	stopThread(1000);
+}
+
+} /* namespace AtomSynth */
@@ -0,0 +1,88 @@
+/*
+ * FirPrewarmer.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_TECHNICAL_FIRPREWARMER_H_
+#define SOURCE_TECHNICAL_FIRPREWARMER_H_
+
+#include <vector>
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Adsp/CachedFir.h"
+
+namespace AtomSynth {
+
+/**
+ * A background thread which computes FIR coefficients
+ * before they are needed, so that the audio thread only
+ * ever has to look them up. Atoms with FIR filters work
+ * out which cutoffs they can reach when a patch is
+ * loaded or their controls change, and request them
+ * here. The kernels are handed to the audio thread with
+ * Adsp::FirFilterCache::prewarm(), so they live in the
+ * same capped slabs as every other kernel. Kernels the
+ * audio thread finds missing anyway are computed first,
+ * see Adsp::FirFilterCache::computeRequested(), which is
+ * checked for every POLL_INTERVAL milliseconds.
+ */
+class FirPrewarmer: public Thread {
+public:
+	static constexpr int POLL_INTERVAL = 5;
+private:
+	struct Request {
+		Adsp::FirCoefficientCache * m_cache;
+		int m_first, m_last; ///< The first and last index of the cutoffs to compute.
+	};
+	CriticalSection m_lock;
+	std::vector<Request> m_requests; ///< Protected by m_lock.
+	static FirPrewarmer * s_instance;
+	FirPrewarmer();
+	/**
+	 * Prepares the cache for a filter type and sample rate,
+	 * and starts the thread if it is not running.
+	 * @return The cache, or nullptr if nothing should be prewarmed for it.
+	 */
+	Adsp::FirCoefficientCache * prepare(int filterType, double sampleRate);
+public:
+	static FirPrewarmer * getInstance();
+	virtual ~FirPrewarmer();
+
+	virtual void run();
+
+	/**
+	 * Prepares the Adsp::FirFilterCache for a filter type
+	 * and sample rate, which filters need before they can
+	 * look up anything, and computes every cached cutoff
+	 * between two frequencies in the background, unless
+	 * they are already loaded from a FirCacheFile, or the
+	 * sample rate is only a placeholder (see
+	 * SynthParameters::m_prepared). Should be called from
+	 * the message thread, never the audio thread.
+	 * @param filterType A bitwise-or combination of window type, filter type and quality from Adsp::FilterType.
+	 * @param sampleRate The sample rate.
+	 * @param lowest The lowest cutoff frequency that might be used.
+	 * @param highest The highest cutoff frequency that might be used.
+	 */
+	void request(int filterType, double sampleRate, double lowest, double highest);
+	/**
+	 * Does the same as the other request(), but only for
+	 * some cutoffs instead of every one in a range.
+	 * @param filterType A bitwise-or combination of window type, filter type and quality from Adsp::FilterType.
+	 * @param sampleRate The sample rate.
+	 * @param cutoffs The cutoff frequencies that might be used. Can be empty, to only prepare the cache.
+	 */
+	void request(int filterType, double sampleRate, const std::vector<double> & cutoffs);
+	/**
+	 * Stops the thread, throwing away any work that has not
+	 * been done yet. It starts again with the next request.
+	 * Until then, kernels the audio thread finds missing are
+	 * not computed.
+	 */
+	void stop();
+};
+
+} /* namespace AtomSynth */
+
+#endif /* SOURCE_TECHNICAL_FIRPREWARMER_H_ */
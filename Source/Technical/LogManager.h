@@ -13,7 +13,8 @@
 
 namespace AtomSynth {
 
-class AudioBuffer;
+template<typename T> class BasicAudioBuffer;
+typedef BasicAudioBuffer<double> AudioBuffer;
 class Synth;
 
 class LogManager {
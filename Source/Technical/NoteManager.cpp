@@ -69,6 +69,7 @@ void NoteManager::addMidiNote(MidiMessage midi) {
 	NoteState note;
 	note.timestamp = m_parent->getParameters().m_timestamp;
 	note.frequency = frequency;
+	note.noteNumber = midi.getNoteNumber();
 	note.velocity = midi.getFloatVelocity();
 	start(index, note);
 }
@@ -102,6 +103,7 @@ void NoteManager::addFrequency(double frequency) {
 	NoteState note;
 	note.timestamp = m_parent->getParameters().m_timestamp;
 	note.frequency = frequency;
+	note.noteNumber = int(std::round(69.0 + 12.0 * std::log2(frequency / 440.0)));
 	note.velocity = 1.0;
 	start(index, note);
 }
@@ -30,6 +30,7 @@ struct NoteState {
 		SILENT ///< There is nothing happening for this note.
 	};
 	double frequency = 440.0; ///< The frequency of the note.
+	int noteNumber = 69; ///< The MIDI note number of the note, or the closest one if it was started from a frequency.
 	double velocity = 1.0; ///< The velocity of the note.
 	double panning = 0.0; ///< The panning of the note. (-1 is left, 1 is right.)
 	unsigned long int timestamp = 0; ///< The time that the note started playing.
@@ -7,6 +7,9 @@
 
 #include "Synth.h"
 
+#include "Adsp/Cpu.h"
+#include "FirCacheFile.h"
+#include "FirPrewarmer.h"
 #include "SaveState.h"
 
 namespace AtomSynth {
@@ -25,17 +28,24 @@ Synth::~Synth() {
 
 }
 
-void Synth::initialize(int sampleRate, int bufferSize) {
+void Synth::initialize(int sampleRate, int bufferSize, bool prepared) {
 	auto instance = getInstance();
 	AudioBuffer::setDefaultSize(bufferSize);
 	AudioBuffer::setDefaultChannels(2);
 	instance->getParameters().m_sampleRate = sampleRate;
 	instance->getParameters().m_polyphony = 32;
+	instance->getParameters().m_prepared = prepared;
 	instance->getAtomManager().setup();
 	instance->getGuiManager().setup();
 	instance->getLogManager().setup();
 	instance->getNoteManager().setup();
 	instance->getSaveManager().setup();
+	//Before any patch is loaded, so that its filters read their coefficients from the file instead of computing them.
+	FirCacheFile::getInstance()->load();
+	//Audio is not being processed during initialization, so tables and caches for the old sample rate can be deleted safely.
+	//Loading the patch again below creates new filters, and prepares and prewarms caches for the current sample rate.
+	FirPrewarmer::getInstance()->stop();
+	Adsp::FirFilterCache::getInstance()->releaseOtherSampleRates(sampleRate);
 	//Only load the default patch if there isn't already another patch loaded.
 	if(instance->getAtomManager().getAtoms().size() == 0) {
 		instance->getSaveManager().loadDefaultPatch();
@@ -43,6 +53,7 @@ void Synth::initialize(int sampleRate, int bufferSize) {
 		//Reload the current state.
 		instance->getAtomManager().loadSaveState(instance->getAtomManager().saveSaveState());
 	}
+	info(std::string("Using ") + Adsp::getSimdLevelName(Adsp::getSimdLevel()) + " for block operations");
 	info("Initialization complete");
 }
 
@@ -21,7 +21,8 @@ namespace AtomSynth {
 
 class Atom;
 class AtomController;
-class AudioBuffer;
+template<typename T> class BasicAudioBuffer;
+typedef BasicAudioBuffer<double> AudioBuffer;
 class SaveManager;
 class SaveState;
 
@@ -35,7 +36,9 @@ const std::string DEFAULT_PATCH = "wNPBswAAAgKVAAAEAGMBAALAAEkAAAoABQIAAOHhAAUCA
 struct SynthParameters {
 	int m_sampleRate = 44100, ///< How many samples are calculated per second.
 			m_timestamp = 0, ///< Increased by one for every sample calculated by the synth. m_timestamp / m_sampleRate will give the number of seconds the synth has been running for.
-			m_polyphony = 32; ///< The maximum number of notes that can be played at once.
+			m_polyphony = 32, ///< The maximum number of notes that can be played at once.
+			m_filterControlRate = 32; ///< How many samples modulated FIR filters keep the same cutoff for. Each change is crossfaded over this many samples.
+	bool m_prepared = false; ///< False until the host has said what the real sample rate is. Until then m_sampleRate is only a placeholder, and nothing that depends on it should be computed in advance.
 	double m_bpm = 140.0; ///< How many beats per minute. This can change rapidly, if the user has automated it in the audio host.
 };
 
@@ -77,8 +80,9 @@ public:
 	 * been established (usually by the plugin host.)
 	 * @param sampleRate The sample rate that should be rendered, in samples per second.
 	 * @param bufferSize The size, in samples, of a single buffer of output.
+	 * @param prepared False if the values are only placeholders until the host says what they are. See SynthParameters::m_prepared.
 	 */
-	static void initialize(int sampleRate, int bufferSize);
+	static void initialize(int sampleRate, int bufferSize, bool prepared = true);
 
 	virtual ~Synth();
 
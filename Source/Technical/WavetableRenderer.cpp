@@ -0,0 +1,59 @@
+/*
+ * WavetableRenderer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "WavetableRenderer.h"
+
+namespace AtomSynth {
+
+WavetableRenderer * WavetableRenderer::s_instance = nullptr;
+
+WavetableRenderer::WavetableRenderer() :
+		Thread("wavetableRenderer") {
+}
+
+WavetableRenderer * WavetableRenderer::getInstance() {
+	if (s_instance == nullptr) {
+		s_instance = new WavetableRenderer();
+	}
+	return s_instance;
+}
+
+WavetableRenderer::~WavetableRenderer() {
+	stop();
+}
+
+void WavetableRenderer::run() {
+	Adsp::WavetableCache * cache = Adsp::WavetableCache::getInstance();
+	while (!threadShouldExit()) {
+		if (!cache->renderRequested()) {
+			wait(POLL_INTERVAL); //request() calls notify(), so requests from the message thread don't wait for this.
+		}
+	}
+}
+
+void WavetableRenderer::request(int waveform, double lowestVar, double highestVar, double lowestCenter, double highestCenter) {
+	typedef Adsp::WavetableCache Cache;
+	Cache * cache = Cache::getInstance();
+	int first = Cache::getKey(waveform, lowestVar, lowestCenter), last = Cache::getKey(waveform, highestVar, highestCenter);
+	for (int variable = first / Cache::VALUES; variable <= last / Cache::VALUES; variable++) {
+		for (int center = first % Cache::VALUES; center <= last % Cache::VALUES; center++) {
+			cache->request(variable * Cache::VALUES + center);
+		}
+	}
+	if (isThreadRunning()) {
+		notify();
+	} else {
+		startThread(2); //Low priority, the audio thread is more important.
+	}
+}
+
+void WavetableRenderer::stop() {
+	signalThreadShouldExit();
+	notify();
+	stopThread(1000);
+}
+
+} /* namespace AtomSynth */
@@ -0,0 +1,59 @@
+/*
+ * WavetableRenderer.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SOURCE_TECHNICAL_WAVETABLERENDERER_H_
+#define SOURCE_TECHNICAL_WAVETABLERENDERER_H_
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Adsp/Wavetable.h"
+
+namespace AtomSynth {
+
+/**
+ * A background thread which renders every wavetable that
+ * Adsp::WavetableCache is asked for, so that the audio
+ * thread never has to. Oscillators in wavetable mode
+ * request the tables their controls can reach when a
+ * patch is loaded or the controls change. Anything else
+ * the audio thread asks for is rendered as soon as this
+ * thread notices, which it checks for every
+ * POLL_INTERVAL milliseconds, since the audio thread
+ * can't wake it up without taking a lock.
+ */
+class WavetableRenderer: public Thread {
+public:
+	static constexpr int POLL_INTERVAL = 5;
+private:
+	static WavetableRenderer * s_instance;
+	WavetableRenderer();
+public:
+	static WavetableRenderer * getInstance();
+	virtual ~WavetableRenderer();
+
+	virtual void run();
+
+	/**
+	 * Renders every table a waveform can reach with var and
+	 * center between two values, and starts the thread if it
+	 * is not running yet. Should be called from the message
+	 * thread, never the audio thread.
+	 * @param waveform Which waveform, see Adsp::Wavetable::Wavetable().
+	 * @param lowestVar The lowest value of the var parameter.
+	 * @param highestVar The highest value of the var parameter.
+	 * @param lowestCenter The lowest value of the center parameter.
+	 * @param highestCenter The highest value of the center parameter.
+	 */
+	void request(int waveform, double lowestVar, double highestVar, double lowestCenter, double highestCenter);
+	/**
+	 * Stops the thread. It starts again with the next
+	 * request.
+	 */
+	void stop();
+};
+
+} /* namespace AtomSynth */
+
+#endif /* SOURCE_TECHNICAL_WAVETABLERENDERER_H_ */
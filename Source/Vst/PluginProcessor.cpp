@@ -19,8 +19,12 @@
 #include "Atoms/Atom.h"
 #include "Gui/Global.h"
 #include "Technical/AudioBuffer.h"
+#include "Technical/DelayLinePool.h"
+#include "Technical/FirCacheFile.h"
+#include "Technical/FirPrewarmer.h"
 #include "Technical/SaveState.h"
 #include "Technical/Synth.h"
+#include "Technical/WavetableRenderer.h"
 #include "Vst/PluginEditor.h"
 
 //==============================================================================
@@ -28,10 +32,14 @@ AtomSynthAudioProcessor::AtomSynthAudioProcessor() :
 		m_frequency(100.0f) {
 	C::loadFont();
 	//feenableexcept(FE_INVALID|FE_OVERFLOW); //I'm getting NaN results that are hard to find.
-	AtomSynth::Synth::getInstance()->initialize(441000, 256); //Initialize with dummy values, so that if any other code that has to run after initialization is called before we know the real values, it will still work.
+	AtomSynth::Synth::getInstance()->initialize(441000, 256, false); //Initialize with dummy values, so that if any other code that has to run after initialization is called before we know the real values, it will still work.
 }
 
 AtomSynthAudioProcessor::~AtomSynthAudioProcessor() {
+	AtomSynth::FirPrewarmer::getInstance()->stop();
+	AtomSynth::WavetableRenderer::getInstance()->stop();
+	AtomSynth::DelayLinePool::getInstance()->stop();
+	AtomSynth::FirCacheFile::getInstance()->save(AtomSynth::Synth::getInstance()->getParameters().m_sampleRate);
 	AtomSynth::Synth::deleteInstance();
 }
 